@@ -1,17 +1,46 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <sys/sendfile.h>
+
+#define COPY_BUFFER_SIZE (128 * 1024)   // read/write 대체 경로 버퍼 크기
+#define ZERO_COPY_CHUNK (1 << 30)       // 커널 복사 호출 한 번에 요청할 최대 바이트 수
+
+// 커널 내부 복사 방식
+enum { COPY_FILE_RANGE, COPY_SPLICE, COPY_SENDFILE };
+
+#define OUTPUT_BUFFER_SIZE (256 * 1024)
+#define NUMBER_WIDTH 6                  // 줄 번호 최소 폭 ("%6d\t")
 
 typedef struct {
-    int number_lines;   // -n 옵션: 줄 번호 출력
+    int number_lines;       // -n 옵션: 줄 번호 출력
+    int number_nonblank;    // -b 옵션: 비어 있지 않은 줄에만 번호 (-n보다 우선)
+    int squeeze_blank;      // -s 옵션: 연속된 빈 줄을 하나로
+    int show_ends;          // -E 옵션: 줄 끝에 '$' 표시
+    int show_tabs;          // -T 옵션: 탭을 ^I로 표시
+    int show_nonprinting;   // -v 옵션: 제어 문자를 ^X, M-X로 표시
 } cat_options;
 
+// 여러 파일에 걸쳐 이어지는 출력 상태
+typedef struct {
+    int at_line_start;      // 다음 바이트가 줄의 시작인지
+    int blank_run;          // 직전까지 연속된 빈 줄 수 (-s)
+    char number[24];        // 오른쪽 정렬된 줄 번호 자릿수 + '\t'
+    char *number_start;     // number 안에서 첫 자릿수 위치
+} cat_state;
+
+// 변환 결과를 모아 쓰는 출력 버퍼
+static char out_buffer[OUTPUT_BUFFER_SIZE];
+static size_t out_len = 0;
+
 // 함수 선언
-int cat_file(const char *filename, cat_options *opts, int *line_number);
-int cat_stdin(cat_options *opts, int *line_number);
+int cat_file(const char *filename, cat_options *opts, cat_state *state);
+int cat_stdin(cat_options *opts, cat_state *state);
 void print_usage(void);
 
 // 사용법 출력
@@ -19,83 +48,320 @@ void print_usage(void) {
     printf("Usage: cat [OPTION]... [FILE]...\n");
     printf("Concatenate FILE(s) to standard output.\n\n");
     printf("With no FILE, or when FILE is -, read standard input.\n\n");
-    printf("  -n, --number     number all output lines\n");
-    printf("      --help       display this help and exit\n");
+    printf("  -A, --show-all           equivalent to -vET\n");
+    printf("  -b, --number-nonblank    number nonempty output lines, overrides -n\n");
+    printf("  -e                       equivalent to -vE\n");
+    printf("  -E, --show-ends          display $ at end of each line\n");
+    printf("  -n, --number             number all output lines\n");
+    printf("  -s, --squeeze-blank      suppress repeated empty output lines\n");
+    printf("  -t                       equivalent to -vT\n");
+    printf("  -T, --show-tabs          display TAB characters as ^I\n");
+    printf("  -v, --show-nonprinting   use ^ and M- notation, except for LFD and TAB\n");
+    printf("      --help               display this help and exit\n");
     printf("\nExamples:\n");
     printf("  cat f - g        Output f's contents, then standard input, then g's contents.\n");
     printf("  cat              Copy standard input to standard output.\n");
 }
 
-// 단일 파일의 내용을 출력하는 함수
-int cat_file(const char *filename, cat_options *opts, int *line_number) {
-    FILE *file;
-    int ch;
-    int at_line_start = 1;  // 줄의 시작인지 확인
+// 버퍼 전체를 표준출력에 씀
+static int write_all(const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t written = write(STDOUT_FILENO, buf, len);
+        if (written == -1) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        buf += written;
+        len -= written;
+    }
+    return 0;
+}
+
+// 커널 안에서 fd 내용을 표준출력으로 복사 (0: 완료, 1: 이 방식은 지원 안 됨, -1: 오류)
+// 중간에 지원 안 됨으로 끝나도 파일 오프셋이 진행되어 있으므로 다음 방식이 이어서 복사함
+static int kernel_copy(int method, int fd) {
+    for (;;) {
+        ssize_t copied;
+        
+        if (method == COPY_FILE_RANGE) {
+            copied = copy_file_range(fd, NULL, STDOUT_FILENO, NULL, ZERO_COPY_CHUNK, 0);
+        } else if (method == COPY_SPLICE) {
+            copied = splice(fd, NULL, STDOUT_FILENO, NULL, ZERO_COPY_CHUNK, SPLICE_F_MORE);
+        } else {
+            copied = sendfile(STDOUT_FILENO, fd, NULL, ZERO_COPY_CHUNK);
+        }
+        
+        if (copied > 0) continue;
+        if (copied == 0) return 0;
+        if (errno == EINTR) continue;
+        if (errno == EINVAL || errno == ENOSYS || errno == EXDEV ||
+            errno == EOPNOTSUPP || errno == EBADF) {
+            return 1;
+        }
+        return -1;
+    }
+}
+
+// 변환 없이 fd 내용을 그대로 표준출력으로 복사
+// 일반 파일 → 일반 파일은 copy_file_range, 파이프로는 splice, 그 밖에는 sendfile을 먼저 시도하고
+// 지원되지 않으면 큰 버퍼로 read/write
+static int copy_fd(const char *name, int fd) {
+    struct stat in_st, out_st;
+    int in_regular = fstat(fd, &in_st) == 0 && S_ISREG(in_st.st_mode);
+    int out_ok = fstat(STDOUT_FILENO, &out_st) == 0;
+    int result = 1;
     
-    // 파일명이 "-"이면 표준 입력 사용
-    if (strcmp(filename, "-") == 0) {
-        return cat_stdin(opts, line_number);
+    // 출력 파일을 입력으로 읽으면 끝없이 커지므로 거부
+    if (in_regular && out_ok && S_ISREG(out_st.st_mode) &&
+        in_st.st_dev == out_st.st_dev && in_st.st_ino == out_st.st_ino &&
+        lseek(fd, 0, SEEK_CUR) < in_st.st_size) {
+        fprintf(stderr, "cat: %s: input file is output file\n", name);
+        return -1;
     }
     
-    // 파일 열기
-    file = fopen(filename, "r");
-    if (file == NULL) {
-        fprintf(stderr, "cat: %s: %s\n", filename, strerror(errno));
+    // 크기가 0으로 보이는 일반 파일(/proc 등)은 커널 복사가 빈 결과를 낼 수 있어 제외
+    int zero_copy = !in_regular || in_st.st_size > 0;
+    
+    if (zero_copy && in_regular && out_ok && S_ISREG(out_st.st_mode)) {
+        result = kernel_copy(COPY_FILE_RANGE, fd);
+    }
+    if (result == 1 && zero_copy && out_ok && S_ISFIFO(out_st.st_mode)) {
+        result = kernel_copy(COPY_SPLICE, fd);
+    }
+    if (result == 1 && zero_copy && in_regular) {
+        result = kernel_copy(COPY_SENDFILE, fd);
+    }
+    if (result == 0) {
+        return 0;
+    }
+    if (result == -1) {
+        fprintf(stderr, "cat: %s: %s\n", name, strerror(errno));
         return -1;
     }
     
-    // 파일이 디렉토리인지 확인
-    struct stat st;
-    if (fstat(fileno(file), &st) == 0 && S_ISDIR(st.st_mode)) {
-        fprintf(stderr, "cat: %s: Is a directory\n", filename);
-        fclose(file);
+    // read/write 대체 경로
+    static char buffer[COPY_BUFFER_SIZE];
+    for (;;) {
+        ssize_t nread = read(fd, buffer, sizeof(buffer));
+        if (nread == -1) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "cat: %s: %s\n", name, strerror(errno));
+            return -1;
+        }
+        if (nread == 0) return 0;
+        if (write_all(buffer, nread) == -1) {
+            fprintf(stderr, "cat: write error: %s\n", strerror(errno));
+            return -1;
+        }
+    }
+}
+
+// 출력 버퍼 내용을 표준출력으로 내보냄
+static int flush_output(void) {
+    if (out_len > 0 && write_all(out_buffer, out_len) == -1) {
+        fprintf(stderr, "cat: write error: %s\n", strerror(errno));
         return -1;
     }
+    out_len = 0;
+    return 0;
+}
+
+// 출력 버퍼에 바이트 추가 (큰 조각은 버퍼를 거치지 않고 바로 씀)
+static int emit(const char *data, size_t len) {
+    if (len > sizeof(out_buffer) - out_len) {
+        if (flush_output() == -1) return -1;
+        if (len >= sizeof(out_buffer)) {
+            if (write_all(data, len) == -1) {
+                fprintf(stderr, "cat: write error: %s\n", strerror(errno));
+                return -1;
+            }
+            return 0;
+        }
+    }
+    memcpy(out_buffer + out_len, data, len);
+    out_len += len;
+    return 0;
+}
+
+// 줄 번호를 1 증가시키고 "%6d\t" 형식으로 출력 (printf 없이 자릿수 문자열을 직접 올림)
+static int emit_line_number(cat_state *state) {
+    char *p = state->number + sizeof(state->number) - 3;   // 마지막 자리 ('\t', '\0' 앞)
     
-    // 파일 내용 읽기 및 출력
-    while ((ch = fgetc(file)) != EOF) {
-        // 줄 번호 출력 (줄의 시작에서)
-        if (opts->number_lines && at_line_start) {
-            printf("%6d\t", (*line_number)++);
-            at_line_start = 0;
+    while (*p == '9') {
+        *p-- = '0';
+    }
+    *p = *p == ' ' ? '1' : *p + 1;
+    if (p < state->number_start) {
+        state->number_start = p;
+    }
+    
+    char *start = state->number + sizeof(state->number) - 2 - NUMBER_WIDTH;
+    if (state->number_start < start) {
+        start = state->number_start;
+    }
+    return emit(start, state->number + sizeof(state->number) - 1 - start);
+}
+
+// 한 줄 안의 조각 출력 (-T/-v이면 특수 문자만 변환하고 나머지는 통째로 복사)
+static int emit_segment(const char *p, const char *end, const unsigned char *special) {
+    while (p < end) {
+        const char *run = p;
+        while (p < end && !special[(unsigned char)*p]) {
+            p++;
         }
+        if (p > run && emit(run, p - run) == -1) return -1;
+        if (p == end) break;
         
-        // 문자 출력
-        putchar(ch);
-        
-        // 개행 문자면 다음 줄의 시작으로 표시
-        if (ch == '\n') {
-            at_line_start = 1;
+        // ^X, ^?, M-X 표기로 변환
+        unsigned char c = *p++;
+        char text[4];
+        int len = 0;
+        if (c >= 128) {
+            text[len++] = 'M';
+            text[len++] = '-';
+            c -= 128;
+        }
+        if (c < 32) {
+            text[len++] = '^';
+            text[len++] = c + 64;
+        } else if (c == 127) {
+            text[len++] = '^';
+            text[len++] = '?';
+        } else {
+            text[len++] = c;
         }
+        if (emit(text, len) == -1) return -1;
     }
-    
-    fclose(file);
     return 0;
 }
 
-// 표준 입력에서 읽어서 출력하는 함수
-int cat_stdin(cat_options *opts, int *line_number) {
-    int ch;
-    int at_line_start = 1;  // 줄의 시작인지 확인
+// 줄 단위 옵션(-n, -b, -s, -E, -T, -v)을 블록 단위로 한 번에 적용
+// 개행은 memchr로 찾고, 줄 번호/표시 문자와 줄 내용 조각을 출력 버퍼에 이어 붙임
+static int transform_fd(const char *name, int fd, cat_options *opts, cat_state *state) {
+    static char buffer[COPY_BUFFER_SIZE];
+    unsigned char special[256] = {0};
+    int escape = opts->show_tabs || opts->show_nonprinting;
+    
+    if (opts->show_nonprinting) {
+        for (int c = 0; c < 256; c++) {
+            special[c] = (c < 32 && c != '\t') || c >= 127;
+        }
+    }
+    if (opts->show_tabs) {
+        special['\t'] = 1;
+    }
+    special['\n'] = 0;
+    
+    const char *line_end = opts->show_ends ? "$\n" : "\n";
+    size_t line_end_len = opts->show_ends ? 2 : 1;
     
-    // 표준 입력에서 읽기
-    while ((ch = getchar()) != EOF) {
-        // 줄 번호 출력 (줄의 시작에서)
-        if (opts->number_lines && at_line_start) {
-            printf("%6d\t", (*line_number)++);
-            at_line_start = 0;
+    for (;;) {
+        ssize_t nread = read(fd, buffer, sizeof(buffer));
+        if (nread == -1) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "cat: %s: %s\n", name, strerror(errno));
+            return -1;
         }
+        if (nread == 0) break;
         
-        // 문자 출력
-        putchar(ch);
+        const char *p = buffer;
+        const char *end = buffer + nread;
         
-        // 개행 문자면 다음 줄의 시작으로 표시
-        if (ch == '\n') {
-            at_line_start = 1;
+        while (p < end) {
+            if (state->at_line_start) {
+                if (*p == '\n') {
+                    // 빈 줄: -s면 연속된 두 번째부터 생략, -b면 번호 없음
+                    p++;
+                    if (opts->squeeze_blank && state->blank_run > 0) {
+                        continue;
+                    }
+                    state->blank_run++;
+                    if (opts->number_lines && !opts->number_nonblank &&
+                        emit_line_number(state) == -1) {
+                        return -1;
+                    }
+                    if (emit(line_end, line_end_len) == -1) return -1;
+                    continue;
+                }
+                state->blank_run = 0;
+                state->at_line_start = 0;
+                if ((opts->number_lines || opts->number_nonblank) &&
+                    emit_line_number(state) == -1) {
+                    return -1;
+                }
+            }
+            
+            const char *nl = memchr(p, '\n', end - p);
+            const char *seg_end = nl ? nl : end;
+            
+            // -E: 줄 끝의 CR은 "^M$"로 표시 (CRLF 줄 끝이 보이도록)
+            int cr_end = nl && opts->show_ends && !opts->show_nonprinting &&
+                         seg_end > p && seg_end[-1] == '\r';
+            if (cr_end) {
+                seg_end--;
+            }
+            
+            if (escape) {
+                if (emit_segment(p, seg_end, special) == -1) return -1;
+            } else if (emit(p, seg_end - p) == -1) {
+                return -1;
+            }
+            
+            if (nl) {
+                if (cr_end && emit("^M", 2) == -1) return -1;
+                if (emit(line_end, line_end_len) == -1) return -1;
+                state->at_line_start = 1;
+                p = nl + 1;
+            } else {
+                p = end;
+            }
         }
     }
     
-    return 0;
+    return flush_output();
+}
+
+// fd 하나를 옵션에 맞게 출력 (변환이 없으면 커널 복사 경로 사용)
+static int cat_fd(const char *name, int fd, cat_options *opts, cat_state *state) {
+    if (!opts->number_lines && !opts->number_nonblank && !opts->squeeze_blank &&
+        !opts->show_ends && !opts->show_tabs && !opts->show_nonprinting) {
+        return copy_fd(name, fd);
+    }
+    return transform_fd(name, fd, opts, state);
+}
+
+// 단일 파일의 내용을 출력하는 함수
+int cat_file(const char *filename, cat_options *opts, cat_state *state) {
+    // 파일명이 "-"이면 표준 입력 사용
+    if (strcmp(filename, "-") == 0) {
+        return cat_stdin(opts, state);
+    }
+    
+    // 파일 열기
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1) {
+        fprintf(stderr, "cat: %s: %s\n", filename, strerror(errno));
+        return -1;
+    }
+    
+    // 파일이 디렉토리인지 확인
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISDIR(st.st_mode)) {
+        fprintf(stderr, "cat: %s: Is a directory\n", filename);
+        close(fd);
+        return -1;
+    }
+    
+    // 파일 내용 읽기 및 출력
+    int result = cat_fd(filename, fd, opts, state);
+    
+    close(fd);
+    return result;
+}
+
+// 표준 입력에서 읽어서 출력하는 함수
+int cat_stdin(cat_options *opts, cat_state *state) {
+    return cat_fd("-", STDIN_FILENO, opts, state);
 }
 
 // 옵션 파싱 함수
@@ -103,7 +369,7 @@ int parse_options(int argc, char *argv[], cat_options *opts, int *file_start) {
     int i;
     
     // 옵션 초기화
-    opts->number_lines = 0;
+    memset(opts, 0, sizeof(*opts));
     
     for (i = 1; i < argc; i++) {
         if (argv[i][0] != '-') {
@@ -127,6 +393,36 @@ int parse_options(int argc, char *argv[], cat_options *opts, int *file_start) {
             continue;
         }
         
+        if (strcmp(argv[i], "--number-nonblank") == 0) {
+            opts->number_nonblank = 1;
+            continue;
+        }
+        
+        if (strcmp(argv[i], "--squeeze-blank") == 0) {
+            opts->squeeze_blank = 1;
+            continue;
+        }
+        
+        if (strcmp(argv[i], "--show-ends") == 0) {
+            opts->show_ends = 1;
+            continue;
+        }
+        
+        if (strcmp(argv[i], "--show-tabs") == 0) {
+            opts->show_tabs = 1;
+            continue;
+        }
+        
+        if (strcmp(argv[i], "--show-nonprinting") == 0) {
+            opts->show_nonprinting = 1;
+            continue;
+        }
+        
+        if (strcmp(argv[i], "--show-all") == 0) {
+            opts->show_nonprinting = opts->show_ends = opts->show_tabs = 1;
+            continue;
+        }
+        
         // "-" 단독으로 사용되면 표준 입력을 의미
         if (strcmp(argv[i], "-") == 0) {
             break;
@@ -139,6 +435,30 @@ int parse_options(int argc, char *argv[], cat_options *opts, int *file_start) {
                 case 'n':
                     opts->number_lines = 1;
                     break;
+                case 'b':
+                    opts->number_nonblank = 1;
+                    break;
+                case 's':
+                    opts->squeeze_blank = 1;
+                    break;
+                case 'E':
+                    opts->show_ends = 1;
+                    break;
+                case 'T':
+                    opts->show_tabs = 1;
+                    break;
+                case 'v':
+                    opts->show_nonprinting = 1;
+                    break;
+                case 'A':
+                    opts->show_nonprinting = opts->show_ends = opts->show_tabs = 1;
+                    break;
+                case 'e':
+                    opts->show_nonprinting = opts->show_ends = 1;
+                    break;
+                case 't':
+                    opts->show_nonprinting = opts->show_tabs = 1;
+                    break;
                 default:
                     fprintf(stderr, "cat: invalid option -- '%c'\n", argv[i][j]);
                     fprintf(stderr, "Try 'cat --help' for more information.\n");
@@ -155,7 +475,7 @@ int main(int argc, char *argv[]) {
     cat_options opts;
     int file_start;
     int result = 0;
-    int line_number = 1;  // 줄 번호 (전체 파일에 걸쳐 연속)
+    cat_state state;      // 줄 번호 등 (전체 파일에 걸쳐 연속)
     int i;
     
     // 옵션 파싱
@@ -167,15 +487,24 @@ int main(int argc, char *argv[]) {
         return 1; // 옵션 파싱 오류
     }
     
+    // 출력 상태 초기화 (줄 번호는 "     0\t"에서 시작해 줄마다 1씩 증가)
+    state.at_line_start = 1;
+    state.blank_run = 0;
+    memset(state.number, ' ', sizeof(state.number));
+    state.number[sizeof(state.number) - 3] = '0';
+    state.number[sizeof(state.number) - 2] = '\t';
+    state.number[sizeof(state.number) - 1] = '\0';
+    state.number_start = state.number + sizeof(state.number) - 3;
+    
     // 파일 인수가 없으면 표준 입력 사용
     if (file_start >= argc) {
-        if (cat_stdin(&opts, &line_number) == -1) {
+        if (cat_stdin(&opts, &state) == -1) {
             result = 1;
         }
     } else {
         // 각 파일 처리
         for (i = file_start; i < argc; i++) {
-            if (cat_file(argv[i], &opts, &line_number) == -1) {
+            if (cat_file(argv[i], &opts, &state) == -1) {
                 result = 1;
             }
         }
@@ -190,6 +519,8 @@ int main(int argc, char *argv[]) {
 // 사용 예시:
 // ./cat file.txt                    # 파일 내용 출력
 // ./cat -n file.txt                 # 줄 번호와 함께 출력
+// ./cat -bs file.txt                # 빈 줄 압축, 비어 있지 않은 줄만 번호
+// ./cat -A file.txt                 # 탭, 줄 끝, 제어 문자 표시
 // ./cat file1.txt file2.txt         # 여러 파일 연결하여 출력
 // ./cat -n file1.txt file2.txt      # 여러 파일 줄 번호와 함께 출력
 // ./cat < input.txt                 # 표준 입력에서 읽기
@@ -1,25 +1,120 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <pthread.h>
 #include <errno.h>
+#include <limits.h>
+#include <ctype.h>
 
-#define MAX_LINE_LENGTH 1024
-#define MAX_LINES 10000
+#define INITIAL_LINES 1024             // 라인 위치 배열 초기 크기
+#define READ_CHUNK_SIZE (64 * 1024)    // mmap할 수 없는 입력의 초기 읽기 버퍼
+#define COMPARE_BLOCK_SIZE (256 * 1024) // 바이트 비교 블록 크기
+#define DIFF_TASK_WINDOW 1024          // 디렉토리 비교에서 출력보다 앞서 처리할 최대 작업 수
+#define WRITER_BUF_SIZE (64 * 1024)    // diff 출력 버퍼 크기
+#define HISTOGRAM_MAX_CHAIN 64   // histogram diff에서 기준점으로 쓸 라인의 최대 등장 횟수
+
+// diff 알고리즘 종류
+enum {
+    ALGO_MYERS,
+    ALGO_PATIENCE,
+    ALGO_HISTOGRAM
+};
+
+// 파일 데이터 안의 라인 하나 (개행 문자 제외)
+typedef struct {
+    size_t offset;
+    size_t length;
+    unsigned int hash;  // 정규화된 내용의 해시 (intern_lines 이후 유효)
+} LineDesc;
 
 typedef struct {
-    char** lines;
+    char* data;     // 파일 내용 (mmap 또는 읽기 버퍼)
+    size_t size;
+    int mapped;     // data가 mmap 영역인지
+    int missing_newline;        // 마지막 줄에 개행 문자가 없는지
+    struct timespec mtime;      // 수정 시각 (-u/-c 헤더용)
+    LineDesc* lines;
+    int* ids;       // 라인별 동치 클래스 ID (intern_lines 이후 유효)
     int count;
     int capacity;
 } FileContent;
 
+// 명령행 옵션
+typedef struct {
+    int unified_format;
+    int context_format;
+    int context_lines;
+    int ignore_case;
+    int ignore_space;
+    int ignore_all_space;
+    int brief;
+    int report_identical;
+    int recursive;       // -r: 하위 디렉토리까지 비교
+    int jobs;            // 디렉토리 비교 작업자 스레드 수
+    int algorithm;
+    char flags[128];     // 디렉토리 비교 헤더에 표시할 옵션 ("diff -r a/x b/x")
+} DiffOptions;
+
+// 디렉토리 비교의 출력 단위 하나 (메시지 또는 파일 쌍 diff)
+typedef struct {
+    char* message;       // "Only in ..." 등 미리 만든 출력 (파일 쌍이면 NULL)
+    char* path1;
+    char* path2;
+    char* output;        // 작업자가 작성한 diff 결과
+    size_t output_len;
+    int status;          // 0: 같음, 1: 다름, 2: 오류
+    int done;
+} DirTask;
+
+// 디렉토리 비교 작업 목록과 스레드 풀 공유 상태
+typedef struct {
+    DirTask* tasks;
+    size_t count;
+    size_t capacity;
+    size_t next;         // 다음에 작업자가 가져갈 인덱스
+    size_t printed;      // 출력이 끝난 작업 수
+    int status;          // 목록 작성 중 발견된 차이/오류
+    const DiffOptions* opts;
+    pthread_mutex_t lock;
+    pthread_cond_t done_cond;
+    pthread_cond_t window_cond;
+} DirTaskList;
+
+// 라인 인터닝 해시 테이블 항목
+typedef struct {
+    const char* line;   // 클래스 대표 라인 (NULL이면 빈 슬롯)
+    size_t length;
+    int incomplete;     // 개행 없이 끝나는 마지막 줄인지 (완전한 줄과 다르게 취급)
+    unsigned int hash;
+    int id;
+} EquivEntry;
+
 typedef struct {
     int type;  // 0: 같음, 1: 추가, 2: 삭제, 3: 변경
-    int line1, line2;  // 원본 파일에서의 라인 번호
+    int line1, line2;  // 원본 파일에서의 라인 번호 (0부터, 블록 시작 위치)
     int count1, count2;  // 변경된 라인 수
 } DiffResult;
 
+// 문맥 라인을 포함한 출력 단위 (변경 블록 first..last)
+typedef struct {
+    int first, last;
+    int start1, count1;  // file1 범위 (0부터)
+    int start2, count2;  // file2 범위 (0부터)
+} Hunk;
+
+// diff 출력 버퍼
+typedef struct {
+    FILE* out;
+    size_t len;
+    char data[WRITER_BUF_SIZE];
+} BufWriter;
+
 // 사용법 출력
 void print_usage(const char* program_name) {
     printf("Usage: %s [OPTION]... FILE1 FILE2\n", program_name);
@@ -33,6 +128,10 @@ void print_usage(const char* program_name) {
     printf("  -b, --ignore-space-change ignore changes in the amount of white space\n");
     printf("  -q, --brief           report only when files differ\n");
     printf("  -s, --report-identical-files report when two files are the same\n");
+    printf("  -r, --recursive       recursively compare any subdirectories found\n");
+    printf("      --jobs=N          compare files of directories with N threads\n");
+    printf("      --patience        use the patience diff algorithm\n");
+    printf("      --histogram       use the histogram diff algorithm\n");
     printf("  -h, --help            display this help and exit\n");
     printf("\n");
     printf("Examples:\n");
@@ -41,222 +140,1064 @@ void print_usage(const char* program_name) {
     printf("  %s -i file1.txt file2.txt    # ignore case\n", program_name);
 }
 
-// 파일 내용을 메모리에 로드
+// st_size가 실제 내용 길이인지 (/proc, sysfs 파일은 0이나 4096으로 보고하고 디스크 블록도 없음)
+static int size_is_reliable(const struct stat* st) {
+    return st->st_size > 0 && st->st_blocks > 0;
+}
+
+// 파일 내용을 메모리에 로드 (크기를 믿을 수 있는 일반 파일은 mmap, 그 외는 끝까지 읽음)
 int load_file(const char* filename, FileContent* content) {
-    FILE* file = fopen(filename, "r");
-    if (!file) {
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1) {
+        fprintf(stderr, "diff: %s: %s\n", filename, strerror(errno));
+        return -1;
+    }
+    
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
         fprintf(stderr, "diff: %s: %s\n", filename, strerror(errno));
+        close(fd);
         return -1;
     }
     
-    content->lines = malloc(MAX_LINES * sizeof(char*));
+    content->data = NULL;
+    content->size = 0;
+    content->mapped = 0;
+    content->mtime = st.st_mtim;
+    
+    if (S_ISREG(st.st_mode) && size_is_reliable(&st)) {
+        void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            madvise(map, st.st_size, MADV_SEQUENTIAL);
+            content->data = map;
+            content->size = st.st_size;
+            content->mapped = 1;
+        }
+    }
+    
+    // mmap할 수 없는 입력(파이프 등)은 버퍼를 키워가며 끝까지 읽음
+    if (!content->mapped) {
+        size_t capacity = READ_CHUNK_SIZE;
+        char* buffer = malloc(capacity);
+        ssize_t nread;
+        if (!buffer) {
+            perror("malloc");
+            close(fd);
+            return -1;
+        }
+        for (;;) {
+            if (content->size == capacity) {
+                capacity *= 2;
+                char* new_buffer = realloc(buffer, capacity);
+                if (!new_buffer) {
+                    perror("realloc");
+                    free(buffer);
+                    close(fd);
+                    return -1;
+                }
+                buffer = new_buffer;
+            }
+            nread = read(fd, buffer + content->size, capacity - content->size);
+            if (nread == -1 && errno == EINTR) {
+                continue;
+            }
+            if (nread <= 0) {
+                break;
+            }
+            content->size += nread;
+        }
+        if (nread == -1) {
+            fprintf(stderr, "diff: %s: %s\n", filename, strerror(errno));
+            free(buffer);
+            close(fd);
+            return -1;
+        }
+        content->data = buffer;
+    }
+    close(fd);
+    content->missing_newline = content->size > 0 && content->data[content->size - 1] != '\n';
+    
+    // 라인 위치 배열 구성 (라인 복사 없음, 길이 제한 없음)
     content->count = 0;
-    content->capacity = MAX_LINES;
+    content->capacity = 0;
+    content->lines = NULL;
     
-    char buffer[MAX_LINE_LENGTH];
-    while (fgets(buffer, sizeof(buffer), file)) {
+    size_t pos = 0;
+    while (pos < content->size) {
+        const char* start = content->data + pos;
+        const char* newline = memchr(start, '\n', content->size - pos);
+        size_t length = newline ? (size_t)(newline - start) : content->size - pos;
+        
         if (content->count >= content->capacity) {
-            content->capacity *= 2;
-            content->lines = realloc(content->lines, content->capacity * sizeof(char*));
-            if (!content->lines) {
+            content->capacity = content->capacity ? content->capacity * 2 : INITIAL_LINES;
+            LineDesc* new_lines = realloc(content->lines, content->capacity * sizeof(LineDesc));
+            if (!new_lines) {
                 perror("realloc");
-                fclose(file);
                 return -1;
             }
+            content->lines = new_lines;
         }
         
-        // 줄 끝의 개행 문자 제거
-        int len = strlen(buffer);
-        if (len > 0 && buffer[len-1] == '\n') {
-            buffer[len-1] = '\0';
-        }
-        
-        content->lines[content->count] = strdup(buffer);
+        content->lines[content->count].offset = pos;
+        content->lines[content->count].length = length;
+        content->lines[content->count].hash = 0;
         content->count++;
+        
+        pos += length + 1;
     }
     
-    fclose(file);
     return 0;
 }
 
 // 메모리 해제
 void free_file_content(FileContent* content) {
-    if (content->lines) {
-        for (int i = 0; i < content->count; i++) {
-            free(content->lines[i]);
-        }
-        free(content->lines);
+    if (content->mapped) {
+        munmap(content->data, content->size);
+    } else {
+        free(content->data);
     }
+    free(content->lines);
+    free(content->ids);
+    content->data = NULL;
+    content->size = 0;
+    content->mapped = 0;
     content->lines = NULL;
+    content->ids = NULL;
     content->count = 0;
     content->capacity = 0;
 }
 
-// 문자열 비교 (옵션에 따라)
-int compare_lines(const char* line1, const char* line2, int ignore_case, int ignore_space, int ignore_all_space) {
-    if (ignore_case) {
-        return strcasecmp(line1, line2);
-    } else {
-        return strcmp(line1, line2);
+// i번째 라인의 시작 위치
+static const char* line_text(FileContent* content, int i) {
+    return content->data + content->lines[i].offset;
+}
+
+// 공백/대소문자 옵션에 따라 정규화된 다음 문자를 돌려줌 (줄 끝이면 -1)
+static int next_normalized_char(const char** p, const char* end, int ignore_case, int ignore_space, int ignore_all_space) {
+    const char* s = *p;
+    
+    for (;;) {
+        if (s == end) {
+            *p = s;
+            return -1;
+        }
+        unsigned char c = *s;
+        if ((ignore_space || ignore_all_space) && isspace(c)) {
+            while (s < end && isspace((unsigned char)*s)) {
+                s++;
+            }
+            if (ignore_all_space) {
+                continue;
+            }
+            // -b: 연속된 공백은 공백 하나로, 줄 끝 공백은 무시
+            *p = s;
+            return s == end ? -1 : ' ';
+        }
+        *p = s + 1;
+        return ignore_case ? tolower(c) : c;
     }
 }
 
-// LCS (Longest Common Subsequence) 알고리즘을 사용한 diff 계산
-void calculate_diff(FileContent* file1, FileContent* file2, int ignore_case, int ignore_space, int ignore_all_space) {
-    int m = file1->count;
-    int n = file2->count;
+// 라인 비교 (옵션에 따라)
+int compare_lines(const char* line1, size_t len1, const char* line2, size_t len2,
+                  int ignore_case, int ignore_space, int ignore_all_space) {
+    if (!ignore_case && !ignore_space && !ignore_all_space) {
+        int cmp = memcmp(line1, line2, len1 < len2 ? len1 : len2);
+        if (cmp != 0 || len1 == len2) {
+            return cmp;
+        }
+        return len1 < len2 ? -1 : 1;
+    }
     
-    // DP 테이블 생성
-    int** dp = malloc((m + 1) * sizeof(int*));
-    for (int i = 0; i <= m; i++) {
-        dp[i] = malloc((n + 1) * sizeof(int));
-        memset(dp[i], 0, (n + 1) * sizeof(int));
+    const char* end1 = line1 + len1;
+    const char* end2 = line2 + len2;
+    for (;;) {
+        int c1 = next_normalized_char(&line1, end1, ignore_case, ignore_space, ignore_all_space);
+        int c2 = next_normalized_char(&line2, end2, ignore_case, ignore_space, ignore_all_space);
+        if (c1 != c2) {
+            return c1 - c2;
+        }
+        if (c1 == -1) {
+            return 0;
+        }
     }
+}
+
+// 정규화된 라인 내용의 해시 (FNV-1a)
+static unsigned int hash_line(const char* line, size_t length, int ignore_case, int ignore_space, int ignore_all_space) {
+    unsigned int hash = 2166136261u;
+    const char* end = line + length;
+    int c;
     
-    // LCS 계산
-    for (int i = 1; i <= m; i++) {
-        for (int j = 1; j <= n; j++) {
-            if (compare_lines(file1->lines[i-1], file2->lines[j-1], ignore_case, ignore_space, ignore_all_space) == 0) {
-                dp[i][j] = dp[i-1][j-1] + 1;
-            } else {
-                dp[i][j] = (dp[i-1][j] > dp[i][j-1]) ? dp[i-1][j] : dp[i][j-1];
+    while ((c = next_normalized_char(&line, end, ignore_case, ignore_space, ignore_all_space)) != -1) {
+        hash = (hash ^ (unsigned char)c) * 16777619u;
+    }
+    return hash;
+}
+
+// 한 파일의 라인들을 동치 클래스 ID로 변환
+static int intern_file(FileContent* content, EquivEntry* table, unsigned int mask, int* next_id,
+                       int ignore_case, int ignore_space, int ignore_all_space) {
+    content->ids = malloc((content->count + 1) * sizeof(int));
+    if (!content->ids) {
+        perror("malloc");
+        return -1;
+    }
+    
+    for (int i = 0; i < content->count; i++) {
+        const char* line = line_text(content, i);
+        size_t length = content->lines[i].length;
+        unsigned int hash = hash_line(line, length, ignore_case, ignore_space, ignore_all_space);
+        // -b/-w에서는 빠진 마지막 개행도 무시할 공백으로 봄 (GNU diff와 같음)
+        int incomplete = i == content->count - 1 && content->missing_newline &&
+                         !ignore_space && !ignore_all_space;
+        unsigned int slot = (hash + incomplete) & mask;
+        
+        content->lines[i].hash = hash;
+        
+        // 선형 탐사로 같은 클래스를 찾거나 새 클래스 등록
+        while (table[slot].line) {
+            if (table[slot].hash == hash && table[slot].incomplete == incomplete &&
+                compare_lines(table[slot].line, table[slot].length, line, length,
+                              ignore_case, ignore_space, ignore_all_space) == 0) {
+                break;
             }
+            slot = (slot + 1) & mask;
+        }
+        if (!table[slot].line) {
+            table[slot].line = line;
+            table[slot].length = length;
+            table[slot].incomplete = incomplete;
+            table[slot].hash = hash;
+            table[slot].id = (*next_id)++;
         }
+        content->ids[i] = table[slot].id;
     }
+    return 0;
+}
+
+// 두 파일의 라인을 정규화·해시하여 정수 ID로 인터닝 (같은 내용 = 같은 ID), 클래스 수 반환
+int intern_lines(FileContent* file1, FileContent* file2, int ignore_case, int ignore_space, int ignore_all_space) {
+    size_t total = (size_t)file1->count + file2->count;
+    size_t size = 16;
     
-    // 역추적하여 차이점 출력
-    int i = m, j = n;
-    int changes = 0;
+    while (size < total * 2) {
+        size <<= 1;
+    }
     
-    while (i > 0 || j > 0) {
-        if (i > 0 && j > 0 && compare_lines(file1->lines[i-1], file2->lines[j-1], ignore_case, ignore_space, ignore_all_space) == 0) {
-            i--;
-            j--;
-        } else if (i > 0 && (j == 0 || dp[i-1][j] >= dp[i][j-1])) {
-            printf("%dd%d\n", i, j);
-            printf("< %s\n", file1->lines[i-1]);
-            i--;
-            changes++;
+    EquivEntry* table = calloc(size, sizeof(EquivEntry));
+    if (!table) {
+        perror("calloc");
+        return -1;
+    }
+    
+    int next_id = 0;
+    int result;
+    if (intern_file(file1, table, size - 1, &next_id, ignore_case, ignore_space, ignore_all_space) == -1 ||
+        intern_file(file2, table, size - 1, &next_id, ignore_case, ignore_space, ignore_all_space) == -1) {
+        result = -1;
+    } else {
+        result = next_id;
+    }
+    
+    free(table);
+    return result;
+}
+
+// Myers 알고리즘 상태 (선형 공간)
+typedef struct {
+    const int* xids;     // file1 라인 ID
+    const int* yids;     // file2 라인 ID
+    int* fdiag;          // 정방향 탐색: 대각선 k에서 도달한 최대 x
+    int* bdiag;          // 역방향 탐색: 대각선 k에서 도달한 최소 x
+    int too_expensive;   // 이 비용을 넘으면 최소성을 포기하고 근사 분할
+    char* changed1;      // file1의 각 라인이 삭제되었는지
+    char* changed2;      // file2의 각 라인이 추가되었는지
+    int* count_a;        // patience/histogram: ID별 file1 구간 내 등장 횟수
+    int* count_b;        // patience: ID별 file2 구간 내 등장 횟수
+    int* pos_b;          // patience: ID별 file2 위치, histogram: ID별 file1 첫 위치
+    int* chain_next;     // histogram: 같은 ID의 다음 file1 위치
+} DiffContext;
+
+// 중간 스네이크로 나눈 분할점
+typedef struct {
+    int xmid, ymid;
+    int lo_minimal;      // 앞쪽 절반을 최소 편집으로 다시 풀어야 하는지
+    int hi_minimal;      // 뒤쪽 절반을 최소 편집으로 다시 풀어야 하는지
+} Partition;
+
+static int lines_equal(DiffContext* ctx, int x, int y) {
+    return ctx->xids[x] == ctx->yids[y];
+}
+
+// 양 끝에서 동시에 탐색해 최단 편집 경로의 중간 스네이크를 찾음
+static void find_middle_snake(DiffContext* ctx, int xoff, int xlim, int yoff, int ylim,
+                              int find_minimal, Partition* part) {
+    int* fd = ctx->fdiag;
+    int* bd = ctx->bdiag;
+    int dmin = xoff - ylim;          // 가능한 최소 대각선
+    int dmax = xlim - yoff;          // 가능한 최대 대각선
+    int fmid = xoff - yoff;          // 정방향 시작 대각선
+    int bmid = xlim - ylim;          // 역방향 시작 대각선
+    int fmin = fmid, fmax = fmid;
+    int bmin = bmid, bmax = bmid;
+    int odd = (fmid - bmid) & 1;     // 홀수면 정방향에서, 짝수면 역방향에서 겹침 확인
+
+    fd[fmid] = xoff;
+    bd[bmid] = xlim;
+
+    for (int c = 1;; c++) {
+        int d;
+
+        // 정방향으로 한 단계 확장
+        if (fmin > dmin) fd[--fmin - 1] = -1; else ++fmin;
+        if (fmax < dmax) fd[++fmax + 1] = -1; else --fmax;
+        for (d = fmax; d >= fmin; d -= 2) {
+            int tlo = fd[d - 1], thi = fd[d + 1];
+            int x = tlo >= thi ? tlo + 1 : thi;
+            int y = x - d;
+            while (x < xlim && y < ylim && lines_equal(ctx, x, y)) {
+                x++;
+                y++;
+            }
+            fd[d] = x;
+            if (odd && bmin <= d && d <= bmax && bd[d] <= x) {
+                part->xmid = x;
+                part->ymid = y;
+                part->lo_minimal = part->hi_minimal = 1;
+                return;
+            }
+        }
+
+        // 역방향으로 한 단계 확장
+        if (bmin > dmin) bd[--bmin - 1] = INT_MAX; else ++bmin;
+        if (bmax < dmax) bd[++bmax + 1] = INT_MAX; else --bmax;
+        for (d = bmax; d >= bmin; d -= 2) {
+            int tlo = bd[d - 1], thi = bd[d + 1];
+            int x = tlo < thi ? tlo : thi - 1;
+            int y = x - d;
+            while (x > xoff && y > yoff && lines_equal(ctx, x - 1, y - 1)) {
+                x--;
+                y--;
+            }
+            bd[d] = x;
+            if (!odd && fmin <= d && d <= fmax && x <= fd[d]) {
+                part->xmid = x;
+                part->ymid = y;
+                part->lo_minimal = part->hi_minimal = 1;
+                return;
+            }
+        }
+
+        if (find_minimal || c < ctx->too_expensive) {
+            continue;
+        }
+
+        // 비용이 너무 크면 가장 멀리 나아간 대각선에서 분할 (최소성 포기)
+        int fxybest = -1, fxbest = xoff;
+        for (d = fmax; d >= fmin; d -= 2) {
+            int x = fd[d] < xlim ? fd[d] : xlim;
+            int y = x - d;
+            if (ylim < y) {
+                x = ylim + d;
+                y = ylim;
+            }
+            if (fxybest < x + y) {
+                fxybest = x + y;
+                fxbest = x;
+            }
+        }
+
+        int bxybest = INT_MAX, bxbest = xlim;
+        for (d = bmax; d >= bmin; d -= 2) {
+            int x = bd[d] > xoff ? bd[d] : xoff;
+            int y = x - d;
+            if (y < yoff) {
+                x = yoff + d;
+                y = yoff;
+            }
+            if (x + y < bxybest) {
+                bxybest = x + y;
+                bxbest = x;
+            }
+        }
+
+        if ((xlim + ylim) - bxybest < fxybest - (xoff + yoff)) {
+            part->xmid = fxbest;
+            part->ymid = fxybest - fxbest;
+            part->lo_minimal = 1;
+            part->hi_minimal = 0;
         } else {
-            printf("%da%d\n", i, j);
-            printf("> %s\n", file2->lines[j-1]);
-            j--;
-            changes++;
+            part->xmid = bxbest;
+            part->ymid = bxybest - bxbest;
+            part->lo_minimal = 0;
+            part->hi_minimal = 1;
         }
+        return;
+    }
+}
+
+// 구간의 공통 접두부/접미부를 잘라내고, 한쪽이 비면 나머지를 모두 변경으로 표시 (처리 끝나면 1)
+static int trim_range(DiffContext* ctx, int* xoff, int* xlim, int* yoff, int* ylim) {
+    while (*xoff < *xlim && *yoff < *ylim && lines_equal(ctx, *xoff, *yoff)) {
+        (*xoff)++;
+        (*yoff)++;
+    }
+    while (*xlim > *xoff && *ylim > *yoff && lines_equal(ctx, *xlim - 1, *ylim - 1)) {
+        (*xlim)--;
+        (*ylim)--;
     }
     
-    // 메모리 해제
-    for (int i = 0; i <= m; i++) {
-        free(dp[i]);
+    if (*xoff == *xlim) {
+        for (int y = *yoff; y < *ylim; y++) {
+            ctx->changed2[y] = 1;
+        }
+        return 1;
+    }
+    if (*yoff == *ylim) {
+        for (int x = *xoff; x < *xlim; x++) {
+            ctx->changed1[x] = 1;
+        }
+        return 1;
     }
-    free(dp);
+    return 0;
 }
 
-// 통합 diff 형식 출력
-void print_unified_diff(const char* file1_name, const char* file2_name, 
-                       FileContent* file1, FileContent* file2, 
-                       int context_lines, int ignore_case, int ignore_space, int ignore_all_space) {
-    printf("--- %s\n", file1_name);
-    printf("+++ %s\n", file2_name);
+// 구간 [xoff, xlim) x [yoff, ylim)을 분할 정복으로 비교해 changed 표시
+static void compare_seq(DiffContext* ctx, int xoff, int xlim, int yoff, int ylim, int find_minimal) {
+    if (trim_range(ctx, &xoff, &xlim, &yoff, &ylim)) {
+        return;
+    }
     
-    int m = file1->count;
-    int n = file2->count;
+    Partition part;
+    find_middle_snake(ctx, xoff, xlim, yoff, ylim, find_minimal, &part);
+    compare_seq(ctx, xoff, part.xmid, yoff, part.ymid, part.lo_minimal);
+    compare_seq(ctx, part.xmid, xlim, part.ymid, ylim, part.hi_minimal);
+}
+
+// patience diff: 양쪽에서 한 번씩만 나오는 라인을 기준점으로 LIS를 구하고 사이 구간을 재귀 처리
+static void patience_seq(DiffContext* ctx, int xoff, int xlim, int yoff, int ylim) {
+    if (trim_range(ctx, &xoff, &xlim, &yoff, &ylim)) {
+        return;
+    }
     
-    // 간단한 라인별 비교
-    int max_lines = (m > n) ? m : n;
-    int line1 = 0, line2 = 0;
-    int hunk_start = -1;
-    int has_changes = 0;
+    const int* xids = ctx->xids;
+    const int* yids = ctx->yids;
+    int* count_a = ctx->count_a;
+    int* count_b = ctx->count_b;
+    int* pos_b = ctx->pos_b;
     
-    for (int i = 0; i < max_lines; i++) {
-        int diff_found = 0;
-        
-        if (line1 < m && line2 < n) {
-            if (compare_lines(file1->lines[line1], file2->lines[line2], ignore_case, ignore_space, ignore_all_space) != 0) {
-                diff_found = 1;
+    for (int x = xoff; x < xlim; x++) {
+        count_a[xids[x]]++;
+    }
+    for (int y = yoff; y < ylim; y++) {
+        count_b[yids[y]]++;
+        pos_b[yids[y]] = y;
+    }
+    
+    // 기준점 후보: file1 순서대로 (x, y) 쌍
+    int range = xlim - xoff;
+    int* anchor_x = malloc(range * sizeof(int));
+    int* anchor_y = malloc(range * sizeof(int));
+    int* tails = malloc(range * sizeof(int));   // 길이 k+1인 증가 수열의 마지막 후보 인덱스
+    int* prev = malloc(range * sizeof(int));    // LIS 역추적 링크
+    if (!anchor_x || !anchor_y || !tails || !prev) {
+        perror("malloc");
+        exit(2);
+    }
+    
+    int anchors = 0;
+    for (int x = xoff; x < xlim; x++) {
+        int id = xids[x];
+        if (count_a[id] == 1 && count_b[id] == 1) {
+            anchor_x[anchors] = x;
+            anchor_y[anchors] = pos_b[id];
+            anchors++;
+        }
+    }
+    
+    // 다음 호출을 위해 카운트 초기화
+    for (int x = xoff; x < xlim; x++) {
+        count_a[xids[x]] = 0;
+    }
+    for (int y = yoff; y < ylim; y++) {
+        count_b[yids[y]] = 0;
+    }
+    
+    // y에 대한 최장 증가 부분 수열 (patience sorting, O(k log k))
+    int lis_len = 0;
+    for (int i = 0; i < anchors; i++) {
+        int lo = 0, hi = lis_len;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (anchor_y[tails[mid]] < anchor_y[i]) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
             }
-        } else if (line1 < m || line2 < n) {
-            diff_found = 1;
+        }
+        prev[i] = lo > 0 ? tails[lo - 1] : -1;
+        tails[lo] = i;
+        if (lo == lis_len) {
+            lis_len++;
+        }
+    }
+    
+    if (lis_len == 0) {
+        // 고유 라인이 없으면 Myers로 처리
+        free(anchor_x);
+        free(anchor_y);
+        free(tails);
+        free(prev);
+        compare_seq(ctx, xoff, xlim, yoff, ylim, 0);
+        return;
+    }
+    
+    // 역추적한 LIS를 앞에서부터 순서대로 정리 (tails 배열 재사용)
+    int* chain = tails;
+    for (int i = lis_len - 1, k = tails[lis_len - 1]; i >= 0; i--, k = prev[k]) {
+        chain[i] = k;
+    }
+    
+    // 기준점 사이의 구간들을 재귀 처리
+    int px = xoff, py = yoff;
+    for (int i = 0; i < lis_len; i++) {
+        int ax = anchor_x[chain[i]];
+        int ay = anchor_y[chain[i]];
+        patience_seq(ctx, px, ax, py, ay);
+        px = ax + 1;
+        py = ay + 1;
+    }
+    free(anchor_x);
+    free(anchor_y);
+    free(tails);
+    free(prev);
+    
+    patience_seq(ctx, px, xlim, py, ylim);
+}
+
+// histogram diff: file1에서 등장 횟수가 가장 적은 라인을 포함하는 공통 구간을 기준으로 분할
+static void histogram_seq(DiffContext* ctx, int xoff, int xlim, int yoff, int ylim) {
+    const int* xids = ctx->xids;
+    const int* yids = ctx->yids;
+    int* count_a = ctx->count_a;
+    int* head = ctx->pos_b;       // ID별 file1 내 첫 등장 위치
+    int* next = ctx->chain_next;  // 같은 ID의 다음 등장 위치
+    
+    // 오른쪽 구간은 재귀 대신 반복으로 처리
+    for (;;) {
+        if (trim_range(ctx, &xoff, &xlim, &yoff, &ylim)) {
+            return;
+        }
+        
+        // file1 구간의 등장 횟수와 위치 체인 구성 (뒤에서부터 넣어 오름차순 유지)
+        for (int x = xlim - 1; x >= xoff; x--) {
+            int id = xids[x];
+            count_a[id]++;
+            next[x] = head[id];
+            head[id] = x;
         }
         
-        if (diff_found) {
-            if (hunk_start == -1) {
-                hunk_start = i;
-                printf("@@ -%d,%d +%d,%d @@\n", 
-                       line1 + 1, (m - line1 > 0) ? m - line1 : 1,
-                       line2 + 1, (n - line2 > 0) ? n - line2 : 1);
+        int found = 0;
+        int best_count = HISTOGRAM_MAX_CHAIN + 1;
+        int best_as = 0, best_ae = 0, best_bs = 0, best_be = 0;
+        
+        for (int y = yoff; y < ylim; ) {
+            int id = yids[y];
+            int next_y = y + 1;
+            
+            if (count_a[id] == 0 || count_a[id] > best_count) {
+                y = next_y;
+                continue;
             }
             
-            if (line1 < m && line2 < n) {
-                printf("-%s\n", file1->lines[line1]);
-                printf("+%s\n", file2->lines[line2]);
-                line1++;
-                line2++;
-            } else if (line1 < m) {
-                printf("-%s\n", file1->lines[line1]);
-                line1++;
-            } else if (line2 < n) {
-                printf("+%s\n", file2->lines[line2]);
-                line2++;
-            }
-            has_changes = 1;
-        } else {
-            if (line1 < m && line2 < n) {
-                if (hunk_start != -1) {
-                    printf(" %s\n", file1->lines[line1]);
+            for (int x = head[id]; x != -1; x = next[x]) {
+                int as = x, ae = x + 1, bs = y, be = y + 1;
+                int rc = count_a[id];
+                
+                while (as > xoff && bs > yoff && xids[as - 1] == yids[bs - 1]) {
+                    as--;
+                    bs--;
+                    if (count_a[xids[as]] < rc) rc = count_a[xids[as]];
+                }
+                while (ae < xlim && be < ylim && xids[ae] == yids[be]) {
+                    if (count_a[xids[ae]] < rc) rc = count_a[xids[ae]];
+                    ae++;
+                    be++;
+                }
+                if (be > next_y) {
+                    next_y = be;
+                }
+                
+                if (rc < best_count || (rc == best_count && ae - as > best_ae - best_as)) {
+                    found = 1;
+                    best_count = rc;
+                    best_as = as;
+                    best_ae = ae;
+                    best_bs = bs;
+                    best_be = be;
                 }
-                line1++;
-                line2++;
             }
+            y = next_y;
         }
+        
+        // 다음 호출을 위해 테이블 초기화
+        for (int x = xoff; x < xlim; x++) {
+            count_a[xids[x]] = 0;
+            head[xids[x]] = -1;
+        }
+        
+        if (!found) {
+            // 충분히 드문 공통 라인이 없으면 Myers로 처리
+            compare_seq(ctx, xoff, xlim, yoff, ylim, 0);
+            return;
+        }
+        
+        histogram_seq(ctx, xoff, best_as, yoff, best_bs);
+        xoff = best_ae;
+        yoff = best_be;
+    }
+}
+
+// 출력 버퍼 비우기
+void bw_flush(BufWriter* w) {
+    if (w->len > 0) {
+        fwrite(w->data, 1, w->len, w->out);
+        w->len = 0;
     }
+}
+
+// 출력 버퍼에 바이트 추가 (가득 차면 FILE*로 내보냄)
+static void bw_write(BufWriter* w, const char* data, size_t len) {
+    if (len > WRITER_BUF_SIZE - w->len) {
+        bw_flush(w);
+        if (len >= WRITER_BUF_SIZE) {
+            fwrite(data, 1, len, w->out);
+            return;
+        }
+    }
+    memcpy(w->data + w->len, data, len);
+    w->len += len;
+}
+
+static void bw_puts(BufWriter* w, const char* str) {
+    bw_write(w, str, strlen(str));
+}
+
+static void bw_num(BufWriter* w, long value) {
+    char buf[24];
+    int pos = sizeof(buf);
+    unsigned long v = value < 0 ? -(unsigned long)value : (unsigned long)value;
     
-    if (!has_changes) {
-        // 파일이 동일함 - 헤더만 출력됨
+    do {
+        buf[--pos] = '0' + v % 10;
+        v /= 10;
+    } while (v != 0);
+    if (value < 0) {
+        buf[--pos] = '-';
     }
+    bw_write(w, buf + pos, sizeof(buf) - pos);
 }
 
-// 컨텍스트 diff 형식 출력
-void print_context_diff(const char* file1_name, const char* file2_name,
-                       FileContent* file1, FileContent* file2,
-                       int context_lines, int ignore_case, int ignore_space, int ignore_all_space) {
-    printf("*** %s\n", file1_name);
-    printf("--- %s\n", file2_name);
+// 접두 기호와 함께 라인 하나 출력 (마지막 줄에 개행이 없으면 표시 추가)
+static void bw_line(BufWriter* w, const char* prefix, FileContent* content, int i) {
+    bw_puts(w, prefix);
+    bw_write(w, line_text(content, i), content->lines[i].length);
+    bw_write(w, "\n", 1);
+    if (i == content->count - 1 && content->missing_newline) {
+        bw_puts(w, "\\ No newline at end of file\n");
+    }
+}
+
+// 변경 구간을 같은 내용의 라인만큼 앞뒤로 밀어 이웃 구간과 합치고,
+// 가능하면 다른 파일의 변경 구간과 마주 보도록 정렬 (GNU diff와 같은 hunk 경계)
+static void shift_boundaries(const int* ids, char* changed, int count, const char* other_changed) {
+    int i = 0, j = 0;
     
-    // 간단한 구현: 모든 다른 라인 출력
+    for (;;) {
+        // 다음 변경 구간의 시작 찾기 (다른 파일의 대응 위치 j도 함께 이동)
+        while (i < count && !changed[i]) {
+            while (other_changed[j++]) continue;
+            i++;
+        }
+        if (i == count) {
+            break;
+        }
+        int start = i;
+        while (changed[++i]) continue;
+        while (other_changed[j]) j++;
+        
+        int run_length, corresponding;
+        do {
+            run_length = i - start;
+            
+            // 앞 라인이 구간의 마지막 라인과 같으면 구간을 앞으로 당김
+            while (start > 0 && ids[start - 1] == ids[i - 1]) {
+                changed[--start] = 1;
+                changed[--i] = 0;
+                while (changed[start - 1]) start--;
+                while (other_changed[--j]) continue;
+            }
+            
+            // 다른 파일의 변경 구간과 맞닿는 마지막 끝 위치 (없으면 count)
+            corresponding = other_changed[j - 1] ? i : count;
+            
+            // 구간의 첫 라인이 바로 뒤 라인과 같으면 구간을 뒤로 밈
+            while (i != count && ids[start] == ids[i]) {
+                changed[start++] = 0;
+                changed[i++] = 1;
+                while (changed[i]) i++;
+                while (other_changed[++j]) corresponding = i;
+            }
+        } while (run_length != i - start);
+        
+        // 가능하면 다른 파일의 변경 구간과 마주 보는 위치로 되돌림
+        while (corresponding < i) {
+            changed[--start] = 1;
+            changed[--i] = 0;
+            while (other_changed[--j]) continue;
+        }
+    }
+}
+
+// 선택한 알고리즘으로 diff 계산 후 변경 블록 목록(편집 스크립트)을 만듦
+DiffResult* compute_edit_script(FileContent* file1, FileContent* file2, int id_count, int algorithm, int* count) {
     int m = file1->count;
     int n = file2->count;
-    int max_lines = (m > n) ? m : n;
+    DiffContext ctx;
+    
+    memset(&ctx, 0, sizeof(ctx));
+    
+    // 공통 접두부/접미부는 알고리즘에 넣지 않음
+    int prefix = 0;
+    while (prefix < m && prefix < n && file1->ids[prefix] == file2->ids[prefix]) {
+        prefix++;
+    }
+    int suffix = 0;
+    while (suffix < m - prefix && suffix < n - prefix &&
+           file1->ids[m - 1 - suffix] == file2->ids[n - 1 - suffix]) {
+        suffix++;
+    }
+    
+    // 가운데 부분만 0부터 시작하는 구간으로 다룸
+    int mid_m = m - prefix - suffix;
+    int mid_n = n - prefix - suffix;
+    // changed 배열은 앞뒤에 0인 보초 칸을 하나씩 둠 (shift_boundaries에서 사용)
+    char* changed_buf1 = calloc(m + 2, 1);
+    char* changed_buf2 = calloc(n + 2, 1);
+    char* changed1 = changed_buf1 + 1;
+    char* changed2 = changed_buf2 + 1;
+    
+    // 대각선 배열은 가운데 부분 크기에 비례 (mid_m + mid_n + 3개씩)
+    int diags = mid_m + mid_n + 3;
+    int* diag_buf = malloc(2 * (size_t)diags * sizeof(int));
+    if (!diag_buf || !changed_buf1 || !changed_buf2) {
+        perror("malloc");
+        exit(2);
+    }
+    ctx.xids = file1->ids + prefix;
+    ctx.yids = file2->ids + prefix;
+    ctx.changed1 = changed1 + prefix;
+    ctx.changed2 = changed2 + prefix;
+    ctx.fdiag = diag_buf + mid_n + 1;
+    ctx.bdiag = ctx.fdiag + diags;
+    
+    // 대략 sqrt(m + n)에 비례하는 비용 한도
+    ctx.too_expensive = 1;
+    for (int d = diags; d != 0; d >>= 2) {
+        ctx.too_expensive <<= 1;
+    }
+    if (ctx.too_expensive < 4096) {
+        ctx.too_expensive = 4096;
+    }
+    
+    if (algorithm != ALGO_MYERS && mid_m > 0 && mid_n > 0) {
+        ctx.count_a = calloc(id_count, sizeof(int));
+        ctx.count_b = calloc(id_count, sizeof(int));
+        ctx.pos_b = malloc(id_count * sizeof(int));
+        ctx.chain_next = malloc(mid_m * sizeof(int));
+        if (!ctx.count_a || !ctx.count_b || !ctx.pos_b || !ctx.chain_next) {
+            perror("malloc");
+            exit(2);
+        }
+        for (int i = 0; i < id_count; i++) {
+            ctx.pos_b[i] = -1;
+        }
+    }
+    
+    if (algorithm == ALGO_PATIENCE) {
+        patience_seq(&ctx, 0, mid_m, 0, mid_n);
+    } else if (algorithm == ALGO_HISTOGRAM) {
+        histogram_seq(&ctx, 0, mid_m, 0, mid_n);
+    } else {
+        compare_seq(&ctx, 0, mid_m, 0, mid_n, 0);
+    }
+    
+    shift_boundaries(file1->ids, changed1, m, changed2);
+    shift_boundaries(file2->ids, changed2, n, changed1);
+    
+    // 연속된 변경 라인을 블록 하나로 묶음
+    DiffResult* script = NULL;
+    int script_count = 0, script_capacity = 0;
+    int i = 0, j = 0;
+    
+    while (i < m || j < n) {
+        if ((i < m && changed1[i]) || (j < n && changed2[j])) {
+            DiffResult block;
+            block.line1 = i;
+            block.line2 = j;
+            while (i < m && changed1[i]) i++;
+            while (j < n && changed2[j]) j++;
+            block.count1 = i - block.line1;
+            block.count2 = j - block.line2;
+            block.type = block.count1 == 0 ? 1 : block.count2 == 0 ? 2 : 3;
+            
+            if (script_count >= script_capacity) {
+                script_capacity = script_capacity ? script_capacity * 2 : 64;
+                DiffResult* new_script = realloc(script, script_capacity * sizeof(DiffResult));
+                if (!new_script) {
+                    perror("realloc");
+                    exit(2);
+                }
+                script = new_script;
+            }
+            script[script_count++] = block;
+        } else {
+            i++;
+            j++;
+        }
+    }
+    
+    // 메모리 해제
+    free(diag_buf);
+    free(changed_buf1);
+    free(changed_buf2);
+    free(ctx.count_a);
+    free(ctx.count_b);
+    free(ctx.pos_b);
+    free(ctx.chain_next);
+    
+    *count = script_count;
+    return script;
+}
+
+// 기본 형식의 범위 출력 (1개면 "a", 여러 개면 "a,b")
+static void print_normal_range(BufWriter* w, int start, int count) {
+    bw_num(w, start + 1);
+    if (count > 1) {
+        bw_write(w, ",", 1);
+        bw_num(w, start + count);
+    }
+}
+
+// 기본 diff 형식 출력 (예: 3c3, 5a6,7, 8,9d9)
+void print_normal_diff(BufWriter* w, FileContent* file1, FileContent* file2,
+                       DiffResult* script, int script_count) {
+    for (int k = 0; k < script_count; k++) {
+        DiffResult* block = &script[k];
+        
+        if (block->type == 1) {
+            bw_num(w, block->line1);
+            bw_write(w, "a", 1);
+            print_normal_range(w, block->line2, block->count2);
+        } else if (block->type == 2) {
+            print_normal_range(w, block->line1, block->count1);
+            bw_write(w, "d", 1);
+            bw_num(w, block->line2);
+        } else {
+            print_normal_range(w, block->line1, block->count1);
+            bw_write(w, "c", 1);
+            print_normal_range(w, block->line2, block->count2);
+        }
+        bw_write(w, "\n", 1);
+        
+        for (int i = 0; i < block->count1; i++) {
+            bw_line(w, "< ", file1, block->line1 + i);
+        }
+        if (block->type == 3) {
+            bw_puts(w, "---\n");
+        }
+        for (int j = 0; j < block->count2; j++) {
+            bw_line(w, "> ", file2, block->line2 + j);
+        }
+    }
+}
+
+// 앞뒤 문맥이 겹치는 변경 블록들을 하나의 hunk로 묶음, 다음 hunk의 첫 블록 인덱스 반환
+static int next_hunk(DiffResult* script, int script_count, int first, int context_lines,
+                     FileContent* file1, Hunk* hunk) {
+    int last = first;
+    
+    while (last + 1 < script_count &&
+           script[last + 1].line1 - (script[last].line1 + script[last].count1) <= 2 * context_lines) {
+        last++;
+    }
+    
+    int lead = script[first].line1 < context_lines ? script[first].line1 : context_lines;
+    int end1 = script[last].line1 + script[last].count1;
+    int trail = file1->count - end1 < context_lines ? file1->count - end1 : context_lines;
+    
+    hunk->first = first;
+    hunk->last = last;
+    hunk->start1 = script[first].line1 - lead;
+    hunk->start2 = script[first].line2 - lead;
+    hunk->count1 = end1 + trail - hunk->start1;
+    hunk->count2 = script[last].line2 + script[last].count2 + trail - hunk->start2;
+    return last + 1;
+}
+
+// 파일 이름과 수정 시각 헤더
+// 통합 형식: "--- a.txt\t2024-01-01 12:00:00.000000000 +0900"
+// 컨텍스트 형식: "*** a.txt\tMon Jan  1 12:00:00 2024"
+static void print_file_header(BufWriter* w, const char* mark, const char* name,
+                              FileContent* content, int unified) {
+    char buf[64];
+    struct tm tm_info;
+    time_t sec = content->mtime.tv_sec;
+    
+    bw_puts(w, mark);
+    bw_write(w, " ", 1);
+    bw_puts(w, name);
+    bw_write(w, "\t", 1);
+    localtime_r(&sec, &tm_info);
+    if (!unified) {
+        strftime(buf, sizeof(buf), "%a %b %e %H:%M:%S %Y\n", &tm_info);
+        bw_puts(w, buf);
+        return;
+    }
+    strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm_info);
+    bw_puts(w, buf);
+    snprintf(buf, sizeof(buf), ".%09ld", (long)content->mtime.tv_nsec);
+    bw_puts(w, buf);
+    strftime(buf, sizeof(buf), " %z\n", &tm_info);
+    bw_puts(w, buf);
+}
+
+// 통합 형식의 범위 출력 (비어 있으면 "앞줄,0", 1개면 "a", 아니면 "a,개수")
+static void print_unified_range(BufWriter* w, int start, int count) {
+    if (count == 0) {
+        bw_num(w, start);
+        bw_puts(w, ",0");
+        return;
+    }
+    bw_num(w, start + 1);
+    if (count > 1) {
+        bw_write(w, ",", 1);
+        bw_num(w, count);
+    }
+}
+
+// 통합 diff 형식 출력
+void print_unified_diff(BufWriter* w, const char* file1_name, const char* file2_name, 
+                       FileContent* file1, FileContent* file2, 
+                       DiffResult* script, int script_count, int context_lines) {
+    print_file_header(w, "---", file1_name, file1, 1);
+    print_file_header(w, "+++", file2_name, file2, 1);
     
-    for (int i = 0; i < max_lines; i++) {
-        if (i < m && i < n) {
-            if (compare_lines(file1->lines[i], file2->lines[i], ignore_case, ignore_space, ignore_all_space) != 0) {
-                printf("***************\n");
-                printf("*** %d ****\n", i + 1);
-                printf("! %s\n", file1->lines[i]);
-                printf("--- %d ----\n", i + 1);
-                printf("! %s\n", file2->lines[i]);
+    Hunk hunk;
+    for (int k = 0; k < script_count; ) {
+        k = next_hunk(script, script_count, k, context_lines, file1, &hunk);
+        
+        bw_puts(w, "@@ -");
+        print_unified_range(w, hunk.start1, hunk.count1);
+        bw_puts(w, " +");
+        print_unified_range(w, hunk.start2, hunk.count2);
+        bw_puts(w, " @@\n");
+        
+        int x = hunk.start1;
+        for (int b = hunk.first; b <= hunk.last; b++) {
+            DiffResult* block = &script[b];
+            while (x < block->line1) {
+                bw_line(w, " ", file1, x++);
+            }
+            for (int i = 0; i < block->count1; i++) {
+                bw_line(w, "-", file1, block->line1 + i);
+            }
+            for (int j = 0; j < block->count2; j++) {
+                bw_line(w, "+", file2, block->line2 + j);
+            }
+            x = block->line1 + block->count1;
+        }
+        while (x < hunk.start1 + hunk.count1) {
+            bw_line(w, " ", file1, x++);
+        }
+    }
+}
+
+// 컨텍스트 형식의 범위 출력 (비어 있으면 앞줄 번호, 1개면 "a", 아니면 "a,b")
+static void print_context_range(BufWriter* w, int start, int count) {
+    if (count == 0) {
+        bw_num(w, start);
+        return;
+    }
+    print_normal_range(w, start, count);
+}
+
+// 컨텍스트 diff 형식 출력
+void print_context_diff(BufWriter* w, const char* file1_name, const char* file2_name,
+                       FileContent* file1, FileContent* file2,
+                       DiffResult* script, int script_count, int context_lines) {
+    print_file_header(w, "***", file1_name, file1, 0);
+    print_file_header(w, "---", file2_name, file2, 0);
+    
+    Hunk hunk;
+    for (int k = 0; k < script_count; ) {
+        k = next_hunk(script, script_count, k, context_lines, file1, &hunk);
+        
+        int has_deletions = 0, has_insertions = 0;
+        for (int b = hunk.first; b <= hunk.last; b++) {
+            has_deletions |= script[b].count1 > 0;
+            has_insertions |= script[b].count2 > 0;
+        }
+        
+        bw_puts(w, "***************\n*** ");
+        print_context_range(w, hunk.start1, hunk.count1);
+        bw_puts(w, " ****\n");
+        if (has_deletions) {
+            int x = hunk.start1;
+            for (int b = hunk.first; b <= hunk.last; b++) {
+                DiffResult* block = &script[b];
+                while (x < block->line1) {
+                    bw_line(w, "  ", file1, x++);
+                }
+                for (int i = 0; i < block->count1; i++) {
+                    bw_line(w, block->type == 3 ? "! " : "- ", file1, x++);
+                }
+            }
+            while (x < hunk.start1 + hunk.count1) {
+                bw_line(w, "  ", file1, x++);
+            }
+        }
+        
+        bw_puts(w, "--- ");
+        print_context_range(w, hunk.start2, hunk.count2);
+        bw_puts(w, " ----\n");
+        if (has_insertions) {
+            int y = hunk.start2;
+            for (int b = hunk.first; b <= hunk.last; b++) {
+                DiffResult* block = &script[b];
+                while (y < block->line2) {
+                    bw_line(w, "  ", file2, y++);
+                }
+                for (int j = 0; j < block->count2; j++) {
+                    bw_line(w, block->type == 3 ? "! " : "+ ", file2, y++);
+                }
+            }
+            while (y < hunk.start2 + hunk.count2) {
+                bw_line(w, "  ", file2, y++);
             }
-        } else if (i < m) {
-            printf("***************\n");
-            printf("*** %d ****\n", i + 1);
-            printf("- %s\n", file1->lines[i]);
-        } else if (i < n) {
-            printf("***************\n");
-            printf("--- %d ----\n", i + 1);
-            printf("+ %s\n", file2->lines[i]);
         }
     }
 }
 
 // 파일이 동일한지 확인
-int files_identical(FileContent* file1, FileContent* file2, int ignore_case, int ignore_space, int ignore_all_space) {
+int files_identical(FileContent* file1, FileContent* file2) {
     if (file1->count != file2->count) {
         return 0;
     }
     
     for (int i = 0; i < file1->count; i++) {
-        if (compare_lines(file1->lines[i], file2->lines[i], ignore_case, ignore_space, ignore_all_space) != 0) {
+        if (file1->ids[i] != file2->ids[i]) {
             return 0;
         }
     }
@@ -264,33 +1205,498 @@ int files_identical(FileContent* file1, FileContent* file2, int ignore_case, int
     return 1;
 }
 
+// len 바이트를 채우거나 파일 끝까지 읽음 (읽은 바이트 수, 오류 시 -1)
+static ssize_t read_full(int fd, char* buf, size_t len) {
+    size_t total = 0;
+    
+    while (total < len) {
+        ssize_t r = read(fd, buf + total, len - total);
+        if (r == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (r == 0) {
+            break;
+        }
+        total += r;
+    }
+    return total;
+}
+
+// 두 파일의 바이트 내용이 같은지 블록 단위로 비교 (다른 곳을 만나면 즉시 중단)
+// 크기와 inode를 먼저 보고, 내용은 고정 크기 버퍼로 읽어 memcmp (라인 구조는 만들지 않음)
+// 반환값: 1 같음, 0 다름, -1 비교할 수 없음 (열기/읽기 오류)
+static int same_bytes(const char* file1_name, const char* file2_name,
+                      const struct stat* st1, const struct stat* st2) {
+    // 같은 inode면 읽을 필요 없음
+    if (st1->st_dev == st2->st_dev && st1->st_ino == st2->st_ino) {
+        return 1;
+    }
+    // 크기가 다르면 내용도 다름 (크기를 믿을 수 있는 파일끼리만)
+    if (size_is_reliable(st1) && size_is_reliable(st2) && st1->st_size != st2->st_size) {
+        return 0;
+    }
+    
+    int fd1 = open(file1_name, O_RDONLY);
+    int fd2 = open(file2_name, O_RDONLY);
+    int result = -1;
+    char* buf1 = malloc(2 * (size_t)COMPARE_BLOCK_SIZE);
+    char* buf2 = buf1 + COMPARE_BLOCK_SIZE;
+    
+    if (fd1 != -1 && fd2 != -1 && buf1) {
+        posix_fadvise(fd1, 0, 0, POSIX_FADV_SEQUENTIAL);
+        posix_fadvise(fd2, 0, 0, POSIX_FADV_SEQUENTIAL);
+        for (;;) {
+            ssize_t n1 = read_full(fd1, buf1, COMPARE_BLOCK_SIZE);
+            ssize_t n2 = read_full(fd2, buf2, COMPARE_BLOCK_SIZE);
+            if (n1 < 0 || n2 < 0) {
+                break;
+            }
+            if (n1 != n2 || memcmp(buf1, buf2, n1) != 0) {
+                result = 0;
+                break;
+            }
+            if (n1 < COMPARE_BLOCK_SIZE) {
+                result = 1;
+                break;
+            }
+        }
+    }
+    
+    if (fd1 != -1) close(fd1);
+    if (fd2 != -1) close(fd2);
+    free(buf1);
+    return result;
+}
+
+// 두 파일 비교 후 결과를 out에 출력 (0: 같음, 1: 다름, 2: 오류)
+// header가 있으면 차이점 앞에 한 줄 출력 (디렉토리 비교 시 "diff -r a/x b/x")
+int diff_files(const char* file1_name, const char* file2_name, const DiffOptions* opts,
+               const char* header, FILE* out) {
+    FileContent file1_content = {0};
+    FileContent file2_content = {0};
+    struct stat st1, st2;
+    
+    // 일반 파일끼리는 라인을 나누기 전에 크기/inode/바이트 비교로 먼저 판단
+    if (stat(file1_name, &st1) == 0 && stat(file2_name, &st2) == 0 &&
+        S_ISREG(st1.st_mode) && S_ISREG(st2.st_mode)) {
+        int same = same_bytes(file1_name, file2_name, &st1, &st2);
+        
+        if (same == 1) {
+            if (opts->report_identical) {
+                fprintf(out, "Files %s and %s are identical\n", file1_name, file2_name);
+            }
+            return 0;
+        }
+        
+        // 무시 옵션이 없으면 바이트가 다르다는 것만으로 -q 결과가 정해짐
+        if (same == 0 && opts->brief &&
+            !opts->ignore_case && !opts->ignore_space && !opts->ignore_all_space) {
+            fprintf(out, "Files %s and %s differ\n", file1_name, file2_name);
+            return 1;
+        }
+    }
+    
+    if (load_file(file1_name, &file1_content) == -1) {
+        return 2;
+    }
+    
+    if (load_file(file2_name, &file2_content) == -1) {
+        free_file_content(&file1_content);
+        return 2;
+    }
+    
+    // 라인을 정수 ID로 변환 (이후 비교는 정수 비교만 수행)
+    int id_count = intern_lines(&file1_content, &file2_content,
+                                opts->ignore_case, opts->ignore_space, opts->ignore_all_space);
+    if (id_count == -1) {
+        free_file_content(&file1_content);
+        free_file_content(&file2_content);
+        return 2;
+    }
+    
+    // 파일 비교
+    int identical = files_identical(&file1_content, &file2_content);
+    
+    if (identical) {
+        if (opts->report_identical) {
+            fprintf(out, "Files %s and %s are identical\n", file1_name, file2_name);
+        }
+        free_file_content(&file1_content);
+        free_file_content(&file2_content);
+        return 0;
+    }
+    
+    if (opts->brief) {
+        fprintf(out, "Files %s and %s differ\n", file1_name, file2_name);
+    } else {
+        // 편집 스크립트를 한 번 만들고 형식별로 hunk를 구성해 출력
+        int script_count = 0;
+        DiffResult* script = compute_edit_script(&file1_content, &file2_content, id_count,
+                                                 opts->algorithm, &script_count);
+        BufWriter* w = malloc(sizeof(BufWriter));
+        if (!w) {
+            perror("malloc");
+            exit(2);
+        }
+        w->out = out;
+        w->len = 0;
+        
+        if (header) {
+            bw_puts(w, header);
+            bw_write(w, "\n", 1);
+        }
+        if (opts->unified_format) {
+            print_unified_diff(w, file1_name, file2_name, &file1_content, &file2_content, 
+                              script, script_count, opts->context_lines);
+        } else if (opts->context_format) {
+            print_context_diff(w, file1_name, file2_name, &file1_content, &file2_content,
+                              script, script_count, opts->context_lines);
+        } else {
+            // 기본 diff 형식
+            print_normal_diff(w, &file1_content, &file2_content, script, script_count);
+        }
+        bw_flush(w);
+        free(w);
+        free(script);
+    }
+    
+    free_file_content(&file1_content);
+    free_file_content(&file2_content);
+    
+    return 1; // 파일이 다름
+}
+
+// 디렉토리 비교에서 파일 쌍 하나를 비교하는 작업
+static int diff_file_pair(DirTask* task, const DiffOptions* opts, FILE* out) {
+    char* header = NULL;
+    if (asprintf(&header, "diff%s %s %s", opts->flags, task->path1, task->path2) == -1) {
+        header = NULL;
+    }
+    int status = diff_files(task->path1, task->path2, opts, header, out);
+    free(header);
+    return status;
+}
+
+// 작업 목록 끝에 항목 추가
+static DirTask* add_task(DirTaskList* list) {
+    if (list->count >= list->capacity) {
+        size_t new_cap = list->capacity ? list->capacity * 2 : 256;
+        DirTask* new_tasks = realloc(list->tasks, new_cap * sizeof(DirTask));
+        if (!new_tasks) {
+            perror("realloc");
+            exit(2);
+        }
+        list->tasks = new_tasks;
+        list->capacity = new_cap;
+    }
+    DirTask* task = &list->tasks[list->count++];
+    memset(task, 0, sizeof(*task));
+    return task;
+}
+
+static void add_message(DirTaskList* list, char* message) {
+    DirTask* task = add_task(list);
+    task->message = message;
+    task->done = 1;
+}
+
+static int compare_names(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+// 디렉토리 항목 이름을 정렬해서 읽음 (. 과 .. 제외)
+static char** read_sorted_dir(const char* path, size_t* count) {
+    DIR* dir = opendir(path);
+    if (!dir) {
+        fprintf(stderr, "diff: %s: %s\n", path, strerror(errno));
+        return NULL;
+    }
+    
+    size_t capacity = 64;
+    char** names = malloc(capacity * sizeof(char*));
+    struct dirent* entry;
+    *count = 0;
+    
+    while (names && (entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+        if (*count >= capacity) {
+            capacity *= 2;
+            char** new_names = realloc(names, capacity * sizeof(char*));
+            if (!new_names) {
+                break;
+            }
+            names = new_names;
+        }
+        names[(*count)++] = strdup(entry->d_name);
+    }
+    closedir(dir);
+    
+    if (names) {
+        qsort(names, *count, sizeof(char*), compare_names);
+    }
+    return names;
+}
+
+static char* join_path(const char* dir, const char* name) {
+    char* path = NULL;
+    if (asprintf(&path, "%s/%s", dir, name) == -1) {
+        perror("asprintf");
+        exit(2);
+    }
+    return path;
+}
+
+static const char* file_kind(const struct stat* st) {
+    mode_t mode = st->st_mode;
+    if (S_ISDIR(mode)) return "directory";
+    if (S_ISREG(mode)) return st->st_size == 0 ? "regular empty file" : "regular file";
+    if (S_ISLNK(mode)) return "symbolic link";
+    if (S_ISFIFO(mode)) return "fifo";
+    return "special file";
+}
+
+// 정렬된 두 디렉토리 목록을 병합하며 출력 순서대로 작업 목록 작성
+static void collect_dir_tasks(const char* dir1, const char* dir2, const DiffOptions* opts,
+                              DirTaskList* list) {
+    size_t count1 = 0, count2 = 0;
+    char** names1 = read_sorted_dir(dir1, &count1);
+    char** names2 = read_sorted_dir(dir2, &count2);
+    char* message;
+    
+    if (!names1 || !names2) {
+        list->status = 2;
+        count1 = names1 ? count1 : 0;
+        count2 = names2 ? count2 : 0;
+    }
+    
+    size_t i = 0, j = 0;
+    while ((names1 && i < count1) || (names2 && j < count2)) {
+        int cmp;
+        if (!names2 || j >= count2) {
+            cmp = -1;
+        } else if (!names1 || i >= count1) {
+            cmp = 1;
+        } else {
+            cmp = strcmp(names1[i], names2[j]);
+        }
+        
+        if (cmp < 0) {
+            if (asprintf(&message, "Only in %s: %s\n", dir1, names1[i]) != -1) {
+                add_message(list, message);
+            }
+            list->status = list->status > 1 ? list->status : 1;
+            i++;
+            continue;
+        }
+        if (cmp > 0) {
+            if (asprintf(&message, "Only in %s: %s\n", dir2, names2[j]) != -1) {
+                add_message(list, message);
+            }
+            list->status = list->status > 1 ? list->status : 1;
+            j++;
+            continue;
+        }
+        
+        char* path1 = join_path(dir1, names1[i]);
+        char* path2 = join_path(dir2, names2[j]);
+        struct stat st1, st2;
+        i++;
+        j++;
+        
+        const char* failed = stat(path1, &st1) == -1 ? path1 : stat(path2, &st2) == -1 ? path2 : NULL;
+        if (failed) {
+            fprintf(stderr, "diff: %s: %s\n", failed, strerror(errno));
+            list->status = 2;
+            free(path1);
+            free(path2);
+            continue;
+        }
+        
+        if (S_ISDIR(st1.st_mode) && S_ISDIR(st2.st_mode)) {
+            if (opts->recursive) {
+                collect_dir_tasks(path1, path2, opts, list);
+            } else if (asprintf(&message, "Common subdirectories: %s and %s\n", path1, path2) != -1) {
+                add_message(list, message);
+            }
+            free(path1);
+            free(path2);
+        } else if (S_ISDIR(st1.st_mode) != S_ISDIR(st2.st_mode)) {
+            if (asprintf(&message, "File %s is a %s while file %s is a %s\n",
+                         path1, file_kind(&st1), path2, file_kind(&st2)) != -1) {
+                add_message(list, message);
+            }
+            list->status = list->status > 1 ? list->status : 1;
+            free(path1);
+            free(path2);
+        } else {
+            DirTask* task = add_task(list);
+            task->path1 = path1;
+            task->path2 = path2;
+        }
+    }
+    
+    for (size_t k = 0; names1 && k < count1; k++) free(names1[k]);
+    for (size_t k = 0; names2 && k < count2; k++) free(names2[k]);
+    free(names1);
+    free(names2);
+}
+
+// 작업자 스레드: 다음 파일 쌍을 가져와 메모리 스트림에 diff 결과 작성
+static void* dir_worker(void* arg) {
+    DirTaskList* list = arg;
+    
+    pthread_mutex_lock(&list->lock);
+    for (;;) {
+        // 출력이 너무 뒤처지면 앞서 나가지 않도록 대기
+        while (list->next < list->count && list->next >= list->printed + DIFF_TASK_WINDOW) {
+            pthread_cond_wait(&list->window_cond, &list->lock);
+        }
+        if (list->next >= list->count) {
+            break;
+        }
+        DirTask* task = &list->tasks[list->next++];
+        if (task->done) {
+            continue;
+        }
+        pthread_mutex_unlock(&list->lock);
+        
+        FILE* out = open_memstream(&task->output, &task->output_len);
+        if (!out) {
+            perror("open_memstream");
+            exit(2);
+        }
+        int status = diff_file_pair(task, list->opts, out);
+        fclose(out);
+        
+        pthread_mutex_lock(&list->lock);
+        task->status = status;
+        task->done = 1;
+        pthread_cond_broadcast(&list->done_cond);
+    }
+    pthread_mutex_unlock(&list->lock);
+    return NULL;
+}
+
+// 두 디렉토리 비교: 작업 목록을 만들고 스레드 풀로 처리하며 순서대로 출력
+int diff_directories(const char* dir1, const char* dir2, const DiffOptions* opts) {
+    DirTaskList list;
+    
+    memset(&list, 0, sizeof(list));
+    list.opts = opts;
+    collect_dir_tasks(dir1, dir2, opts, &list);
+    
+    pthread_mutex_init(&list.lock, NULL);
+    pthread_cond_init(&list.done_cond, NULL);
+    pthread_cond_init(&list.window_cond, NULL);
+    
+    int nthreads = opts->jobs;
+    pthread_t* threads = malloc(nthreads * sizeof(pthread_t));
+    int started = 0;
+    while (threads && started < nthreads &&
+           pthread_create(&threads[started], NULL, dir_worker, &list) == 0) {
+        started++;
+    }
+    
+    int status = list.status;
+    for (size_t i = 0; i < list.count; i++) {
+        DirTask* task = &list.tasks[i];
+        
+        if (task->message) {
+            fputs(task->message, stdout);
+            free(task->message);
+        } else {
+            pthread_mutex_lock(&list.lock);
+            // 작업자가 없으면 (스레드 생성 실패) 직접 처리
+            if (started == 0 && !task->done && list.next <= i) {
+                list.next = i + 1;
+                pthread_mutex_unlock(&list.lock);
+                task->status = diff_file_pair(task, opts, stdout);
+                pthread_mutex_lock(&list.lock);
+                task->done = 1;
+            }
+            while (!task->done) {
+                pthread_cond_wait(&list.done_cond, &list.lock);
+            }
+            pthread_mutex_unlock(&list.lock);
+            
+            if (task->output) {
+                fwrite(task->output, 1, task->output_len, stdout);
+                free(task->output);
+            }
+            if (task->status > status) {
+                status = task->status;
+            }
+            free(task->path1);
+            free(task->path2);
+        }
+        
+        pthread_mutex_lock(&list.lock);
+        list.printed = i + 1;
+        pthread_cond_broadcast(&list.window_cond);
+        pthread_mutex_unlock(&list.lock);
+    }
+    
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+    free(list.tasks);
+    pthread_mutex_destroy(&list.lock);
+    pthread_cond_destroy(&list.done_cond);
+    pthread_cond_destroy(&list.window_cond);
+    
+    return status;
+}
+
 int main(int argc, char* argv[]) {
-    int unified_format = 0;
-    int context_format = 0;
-    int context_lines = 3;
-    int ignore_case = 0;
-    int ignore_space = 0;
-    int ignore_all_space = 0;
-    int brief = 0;
-    int report_identical = 0;
+    DiffOptions opts;
     int opt_index = 1;
+    size_t flags_len = 0;
+    
+    memset(&opts, 0, sizeof(opts));
+    opts.context_lines = 3;
+    opts.algorithm = ALGO_MYERS;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    opts.jobs = cpus > 0 ? (int)cpus : 1;
     
     // 옵션 파싱
     while (opt_index < argc && argv[opt_index][0] == '-') {
         if (strcmp(argv[opt_index], "-u") == 0 || strcmp(argv[opt_index], "--unified") == 0) {
-            unified_format = 1;
+            opts.unified_format = 1;
+        } else if (strncmp(argv[opt_index], "--unified=", 10) == 0) {
+            opts.unified_format = 1;
+            opts.context_lines = atoi(argv[opt_index] + 10);
         } else if (strcmp(argv[opt_index], "-c") == 0 || strcmp(argv[opt_index], "--context") == 0) {
-            context_format = 1;
+            opts.context_format = 1;
+        } else if (strncmp(argv[opt_index], "--context=", 10) == 0) {
+            opts.context_format = 1;
+            opts.context_lines = atoi(argv[opt_index] + 10);
         } else if (strcmp(argv[opt_index], "-i") == 0 || strcmp(argv[opt_index], "--ignore-case") == 0) {
-            ignore_case = 1;
+            opts.ignore_case = 1;
         } else if (strcmp(argv[opt_index], "-w") == 0 || strcmp(argv[opt_index], "--ignore-all-space") == 0) {
-            ignore_all_space = 1;
+            opts.ignore_all_space = 1;
         } else if (strcmp(argv[opt_index], "-b") == 0 || strcmp(argv[opt_index], "--ignore-space-change") == 0) {
-            ignore_space = 1;
+            opts.ignore_space = 1;
         } else if (strcmp(argv[opt_index], "-q") == 0 || strcmp(argv[opt_index], "--brief") == 0) {
-            brief = 1;
+            opts.brief = 1;
         } else if (strcmp(argv[opt_index], "-s") == 0 || strcmp(argv[opt_index], "--report-identical-files") == 0) {
-            report_identical = 1;
+            opts.report_identical = 1;
+        } else if (strcmp(argv[opt_index], "-r") == 0 || strcmp(argv[opt_index], "--recursive") == 0) {
+            opts.recursive = 1;
+        } else if (strncmp(argv[opt_index], "--jobs=", 7) == 0) {
+            opts.jobs = atoi(argv[opt_index] + 7);
+            if (opts.jobs < 1) {
+                opts.jobs = 1;
+            }
+        } else if (strcmp(argv[opt_index], "--patience") == 0) {
+            opts.algorithm = ALGO_PATIENCE;
+        } else if (strcmp(argv[opt_index], "--histogram") == 0) {
+            opts.algorithm = ALGO_HISTOGRAM;
         } else if (strcmp(argv[opt_index], "-h") == 0 || strcmp(argv[opt_index], "--help") == 0) {
             print_usage(argv[0]);
             return 0;
@@ -299,6 +1705,14 @@ int main(int argc, char* argv[]) {
             print_usage(argv[0]);
             return 1;
         }
+        
+        // 디렉토리 비교 시 "diff -r ..." 헤더에 쓸 옵션 문자열
+        size_t arg_len = strlen(argv[opt_index]);
+        if (strncmp(argv[opt_index], "--jobs=", 7) != 0 && flags_len + arg_len + 2 < sizeof(opts.flags)) {
+            opts.flags[flags_len++] = ' ';
+            memcpy(opts.flags + flags_len, argv[opt_index], arg_len + 1);
+            flags_len += arg_len;
+        }
         opt_index++;
     }
     
@@ -323,52 +1737,30 @@ int main(int argc, char* argv[]) {
         return 2;
     }
     
-    // 디렉토리인지 확인
-    if (S_ISDIR(st1.st_mode) || S_ISDIR(st2.st_mode)) {
-        fprintf(stderr, "diff: directory comparison not implemented\n");
-        return 2;
-    }
-    
-    // 파일 로드
-    FileContent file1_content = {0};
-    FileContent file2_content = {0};
-    
-    if (load_file(file1_name, &file1_content) == -1) {
-        return 2;
+    // 디렉토리끼리 비교
+    if (S_ISDIR(st1.st_mode) && S_ISDIR(st2.st_mode)) {
+        return diff_directories(file1_name, file2_name, &opts);
     }
     
-    if (load_file(file2_name, &file2_content) == -1) {
-        free_file_content(&file1_content);
-        return 2;
-    }
-    
-    // 파일 비교
-    int identical = files_identical(&file1_content, &file2_content, ignore_case, ignore_space, ignore_all_space);
-    
-    if (identical) {
-        if (report_identical) {
-            printf("Files %s and %s are identical\n", file1_name, file2_name);
+    // 파일과 디렉토리: 디렉토리 안의 같은 이름 파일과 비교
+    char* joined = NULL;
+    if (S_ISDIR(st1.st_mode) || S_ISDIR(st2.st_mode)) {
+        const char* file = S_ISDIR(st1.st_mode) ? file2_name : file1_name;
+        const char* base = strrchr(file, '/');
+        base = base ? base + 1 : file;
+        if (S_ISDIR(st1.st_mode)) {
+            joined = join_path(file1_name, base);
+            file1_name = joined;
+        } else {
+            joined = join_path(file2_name, base);
+            file2_name = joined;
         }
-        free_file_content(&file1_content);
-        free_file_content(&file2_content);
-        return 0;
-    }
-    
-    if (brief) {
-        printf("Files %s and %s differ\n", file1_name, file2_name);
-    } else if (unified_format) {
-        print_unified_diff(file1_name, file2_name, &file1_content, &file2_content, 
-                          context_lines, ignore_case, ignore_space, ignore_all_space);
-    } else if (context_format) {
-        print_context_diff(file1_name, file2_name, &file1_content, &file2_content,
-                          context_lines, ignore_case, ignore_space, ignore_all_space);
-    } else {
-        // 기본 diff 형식
-        calculate_diff(&file1_content, &file2_content, ignore_case, ignore_space, ignore_all_space);
     }
     
-    free_file_content(&file1_content);
-    free_file_content(&file2_content);
-    
-    return 1; // 파일이 다름
-}
\ No newline at end of file
+    int status = diff_files(file1_name, file2_name, &opts, NULL, stdout);
+    free(joined);
+    return status;
+}
+
+// 컴파일 방법:
+// gcc -o diff diff.c -pthread
\ No newline at end of file
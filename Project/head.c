@@ -5,21 +5,37 @@
 #include <sys/stat.h>
 #include <errno.h>
 #include <ctype.h>
+#include <fcntl.h>
+#include <limits.h>
 
 #define DEFAULT_LINES 10
-#define MAX_LINE_LENGTH 4096
+#define BUFFER_SIZE (128 * 1024)   // 읽기 블록 크기
 
 typedef struct {
-    int num_lines;      // 출력할 줄 수
+    long long count;    // 출력할 줄 수 (또는 -c 바이트 수)
+    int bytes;          // -c 옵션: 바이트 단위
+    int elide_tail;     // 음수 개수: 마지막 count개를 제외하고 출력
     int quiet;          // -q 옵션: 파일명 헤더 출력 안함
     int verbose;        // -v 옵션: 항상 파일명 헤더 출력
 } head_options;
 
+// 음수 개수 처리용 바이트 링 (위치는 스트림 기준)
+typedef struct {
+    char *data;
+    size_t capacity;
+    unsigned long long begin;   // 아직 출력하지 않은 첫 바이트 위치
+    unsigned long long end;     // 지금까지 읽은 바이트 수
+} ByteRing;
+
+// 모든 파일이 함께 쓰는 읽기 버퍼
+static char io_buffer[BUFFER_SIZE];
+
 // 함수 선언
 int head_file(const char *filename, head_options *opts);
 int head_stdin(head_options *opts);
 void print_usage(void);
-int parse_number(const char *str);
+long long parse_number(const char *str, const char *what);
+int set_count(head_options *opts, const char *str, int bytes);
 
 // 사용법 출력
 void print_usage(void) {
@@ -27,7 +43,9 @@ void print_usage(void) {
     printf("Print the first 10 lines of each FILE to standard output.\n");
     printf("With more than one FILE, precede each with a header giving the file name.\n");
     printf("With no FILE, or when FILE is -, read standard input.\n\n");
-    printf("  -n, --lines=NUM      print the first NUM lines instead of the first 10;\n");
+    printf("  -c, --bytes=[-]NUM   print the first NUM bytes of each file;\n");
+    printf("                       with the leading '-', print all but the last NUM bytes\n");
+    printf("  -n, --lines=[-]NUM   print the first NUM lines instead of the first 10;\n");
     printf("                       with the leading '-', print all but the last NUM lines\n");
     printf("  -q, --quiet, --silent never print headers giving file names\n");
     printf("  -v, --verbose        always print headers giving file names\n");
@@ -42,17 +60,17 @@ void print_usage(void) {
 }
 
 // 숫자 파싱 함수 (multiplier suffix 지원)
-int parse_number(const char *str) {
+long long parse_number(const char *str, const char *what) {
     char *endptr;
-    long num = strtol(str, &endptr, 10);
+    long long num = strtoll(str, &endptr, 10);
     
     if (num < 0) {
-        fprintf(stderr, "head: invalid number of lines: '%s'\n", str);
+        fprintf(stderr, "head: invalid number of %s: '%s'\n", what, str);
         return -1;
     }
     
     if (num == 0 && endptr == str) {
-        fprintf(stderr, "head: invalid number of lines: '%s'\n", str);
+        fprintf(stderr, "head: invalid number of %s: '%s'\n", what, str);
         return -1;
     }
     
@@ -83,50 +101,222 @@ int parse_number(const char *str) {
                 if (*(endptr + 1) == 'B') {
                     num *= 1000000000;
                 } else {
-                    num *= 1024 * 1024 * 1024;
+                    num *= 1024LL * 1024 * 1024;
                 }
                 break;
             default:
-                fprintf(stderr, "head: invalid suffix in number of lines: '%s'\n", str);
+                fprintf(stderr, "head: invalid suffix in number of %s: '%s'\n", what, str);
                 return -1;
         }
     }
     
-    if (num > INT_MAX) {
-        fprintf(stderr, "head: number of lines too large: '%s'\n", str);
+    return num;
+}
+
+// -n/-c 인자 설정 (앞에 '-'가 붙으면 마지막 NUM개를 제외)
+int set_count(head_options *opts, const char *str, int bytes) {
+    int elide = str[0] == '-';
+    long long num = parse_number(str + elide, bytes ? "bytes" : "lines");
+    if (num == -1) return -1;
+    
+    opts->count = num;
+    opts->bytes = bytes;
+    opts->elide_tail = elide;
+    return 0;
+}
+
+// 버퍼 전체를 표준출력에 씀
+static int write_all(const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t written = write(STDOUT_FILENO, buf, len);
+        if (written == -1) {
+            if (errno == EINTR) continue;
+            perror("head: error writing 'standard output'");
+            return -1;
+        }
+        buf += written;
+        len -= written;
+    }
+    return 0;
+}
+
+// 블록 하나 읽기 (EINTR 재시도, 오류 시 메시지 출력 후 -1)
+static ssize_t read_block(const char *name, int fd, char *buf, size_t len) {
+    for (;;) {
+        ssize_t nread = read(fd, buf, len);
+        if (nread >= 0) return nread;
+        if (errno != EINTR) {
+            fprintf(stderr, "head: error reading '%s': %s\n", name, strerror(errno));
+            return -1;
+        }
+    }
+}
+
+// 링 인덱스 (용량은 2의 거듭제곱)
+#define RING_INDEX(ring, pos) ((size_t)(pos) & ((ring)->capacity - 1))
+
+// 링이 extra 바이트를 더 받을 수 있도록 확장
+static int ring_reserve(ByteRing *ring, size_t extra) {
+    size_t used = ring->end - ring->begin;
+    if (used + extra <= ring->capacity) return 0;
+
+    size_t capacity = ring->capacity ? ring->capacity : BUFFER_SIZE;
+    while (capacity < used + extra) capacity *= 2;
+
+    char *data = malloc(capacity);
+    if (!data) {
+        perror("head");
         return -1;
     }
-    
-    return (int)num;
+    for (unsigned long long pos = ring->begin; pos < ring->end; ) {
+        size_t idx = RING_INDEX(ring, pos);
+        size_t chunk = ring->capacity - idx;
+        if (chunk > ring->end - pos) chunk = ring->end - pos;
+        memcpy(data + (pos & (capacity - 1)), ring->data + idx, chunk);
+        pos += chunk;
+    }
+    free(ring->data);
+    ring->data = data;
+    ring->capacity = capacity;
+    return 0;
 }
 
-// 표준 입력에서 읽어서 head 처리
-int head_stdin(head_options *opts) {
-    char line[MAX_LINE_LENGTH];
-    int line_count = 0;
-    
-    while (line_count < opts->num_lines && fgets(line, sizeof(line), stdin) != NULL) {
-        printf("%s", line);
-        line_count++;
+// 새로 읽은 바이트를 링 끝에 추가
+static void ring_append(ByteRing *ring, const char *buf, size_t len) {
+    while (len > 0) {
+        size_t idx = RING_INDEX(ring, ring->end);
+        size_t chunk = ring->capacity - idx;
+        if (chunk > len) chunk = len;
+        memcpy(ring->data + idx, buf, chunk);
+        ring->end += chunk;
+        buf += chunk;
+        len -= chunk;
+    }
+}
+
+// 링 앞쪽에서 to 위치 직전까지 출력하고 버림
+static int ring_release(ByteRing *ring, unsigned long long to) {
+    while (ring->begin < to) {
+        size_t idx = RING_INDEX(ring, ring->begin);
+        size_t chunk = ring->capacity - idx;
+        if (chunk > to - ring->begin) chunk = to - ring->begin;
+        if (write_all(ring->data + idx, chunk) < 0) return -1;
+        ring->begin += chunk;
     }
-    
     return 0;
 }
 
+// 음수 개수 (-n -N, -c -N): 마지막 N줄/N바이트를 제외하고 출력
+// 뒤에 N줄(바이트)이 더 있다고 확인된 부분만 내보내고, 나머지는 링에 보관 (꼬리 크기로 제한)
+static int head_elide_tail(const char *name, int fd, head_options *opts) {
+    ByteRing ring = {0};
+    unsigned long long *newlines = NULL;   // 최근 N개 개행 위치 (원형)
+    long long seen = 0;
+    long long n = opts->count;
+    int result = 0;
+
+    if (!opts->bytes && n > 0 && !(newlines = malloc(n * sizeof(*newlines)))) {
+        perror("head");
+        return -1;
+    }
+
+    for (;;) {
+        ssize_t nread = read_block(name, fd, io_buffer, BUFFER_SIZE);
+        if (nread <= 0) {
+            result = nread;
+            break;
+        }
+        if (n == 0) {
+            // 제외할 것이 없으면 그대로 출력
+            if (write_all(io_buffer, nread) < 0) return -1;
+            continue;
+        }
+        if (ring_reserve(&ring, nread) < 0) {
+            result = -1;
+            break;
+        }
+        unsigned long long base = ring.end;
+        ring_append(&ring, io_buffer, nread);
+
+        if (opts->bytes) {
+            if (ring.end - ring.begin > (unsigned long long)n &&
+                ring_release(&ring, ring.end - n) < 0) {
+                result = -1;
+                break;
+            }
+            continue;
+        }
+
+        // 개행 j를 만나면 j-N번째 줄까지는 마지막 N줄에 속하지 않음
+        for (char *p = io_buffer; (p = memchr(p, '\n', io_buffer + nread - p)) != NULL; p++) {
+            if (seen >= n && ring_release(&ring, newlines[seen % n] + 1) < 0) {
+                result = -1;
+                break;
+            }
+            newlines[seen % n] = base + (p - io_buffer);
+            seen++;
+        }
+        if (result < 0) break;
+    }
+
+    // 마지막 줄이 개행 없이 끝나면 그 줄이 마지막 N줄에 포함되므로 한 줄 더 출력
+    if (result == 0 && !opts->bytes && n > 0 && seen >= n &&
+        ring.end > 0 && newlines[(seen - 1) % n] != ring.end - 1) {
+        result = ring_release(&ring, newlines[seen % n] + 1);
+    }
+
+    free(ring.data);
+    free(newlines);
+    return result;
+}
+
+// fd에서 앞부분 출력: 큰 블록으로 읽어 memchr로 개행을 세고,
+// N줄/N바이트를 채우는 즉시 해당 부분까지만 write한 뒤 읽기 중단
+static int head_fd(const char *name, int fd, head_options *opts) {
+    if (opts->elide_tail) {
+        return head_elide_tail(name, fd, opts);
+    }
+
+    long long remaining = opts->count;
+    while (remaining > 0) {
+        size_t want = BUFFER_SIZE;
+        if (opts->bytes && remaining < (long long)want) want = remaining;
+
+        ssize_t nread = read_block(name, fd, io_buffer, want);
+        if (nread <= 0) return nread;
+
+        size_t len = nread;
+        if (opts->bytes) {
+            remaining -= nread;
+        } else {
+            char *p = io_buffer;
+            char *end = io_buffer + nread;
+            while (remaining > 0 && (p = memchr(p, '\n', end - p)) != NULL) {
+                p++;
+                remaining--;
+            }
+            if (remaining == 0) len = p - io_buffer;
+        }
+        if (write_all(io_buffer, len) < 0) return -1;
+    }
+    return 0;
+}
+
+// 표준 입력에서 읽어서 head 처리
+int head_stdin(head_options *opts) {
+    return head_fd("standard input", STDIN_FILENO, opts);
+}
+
 // 파일에서 head 처리
 int head_file(const char *filename, head_options *opts) {
-    FILE *file;
-    char line[MAX_LINE_LENGTH];
-    int line_count = 0;
-    
     // 파일명이 "-"이면 표준 입력 사용
     if (strcmp(filename, "-") == 0) {
         return head_stdin(opts);
     }
     
     // 파일 열기
-    file = fopen(filename, "r");
-    if (file == NULL) {
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1) {
         fprintf(stderr, "head: cannot open '%s' for reading: %s\n", 
                 filename, strerror(errno));
         return -1;
@@ -134,20 +324,17 @@ int head_file(const char *filename, head_options *opts) {
     
     // 파일이 디렉토리인지 확인
     struct stat st;
-    if (fstat(fileno(file), &st) == 0 && S_ISDIR(st.st_mode)) {
+    if (fstat(fd, &st) == 0 && S_ISDIR(st.st_mode)) {
         fprintf(stderr, "head: error reading '%s': Is a directory\n", filename);
-        fclose(file);
+        close(fd);
         return -1;
     }
     
     // 파일 내용 읽기 및 출력
-    while (line_count < opts->num_lines && fgets(line, sizeof(line), file) != NULL) {
-        printf("%s", line);
-        line_count++;
-    }
+    int result = head_fd(filename, fd, opts);
     
-    fclose(file);
-    return 0;
+    close(fd);
+    return result;
 }
 
 // 옵션 파싱 함수
@@ -155,7 +342,9 @@ int parse_options(int argc, char *argv[], head_options *opts, int *file_start) {
     int i;
     
     // 옵션 초기화
-    opts->num_lines = DEFAULT_LINES;
+    opts->count = DEFAULT_LINES;
+    opts->bytes = 0;
+    opts->elide_tail = 0;
     opts->quiet = 0;
     opts->verbose = 0;
     
@@ -177,9 +366,12 @@ int parse_options(int argc, char *argv[], head_options *opts, int *file_start) {
         }
         
         if (strncmp(argv[i], "--lines=", 8) == 0) {
-            int num = parse_number(argv[i] + 8);
-            if (num == -1) return -1;
-            opts->num_lines = num;
+            if (set_count(opts, argv[i] + 8, 0) == -1) return -1;
+            continue;
+        }
+        
+        if (strncmp(argv[i], "--bytes=", 8) == 0) {
+            if (set_count(opts, argv[i] + 8, 1) == -1) return -1;
             continue;
         }
         
@@ -206,25 +398,19 @@ int parse_options(int argc, char *argv[], head_options *opts, int *file_start) {
                 // -n 옵션
                 if (argv[i][2] != '\0') {
                     // -n20 형태
-                    int num = parse_number(argv[i] + 2);
-                    if (num == -1) return -1;
-                    opts->num_lines = num;
+                    if (set_count(opts, argv[i] + 2, 0) == -1) return -1;
                 } else {
                     // -n 20 형태
                     if (i + 1 >= argc) {
                         fprintf(stderr, "head: option requires an argument -- 'n'\n");
                         return -1;
                     }
-                    int num = parse_number(argv[i + 1]);
-                    if (num == -1) return -1;
-                    opts->num_lines = num;
+                    if (set_count(opts, argv[i + 1], 0) == -1) return -1;
                     i++; // 다음 인수 건너뛰기
                 }
             } else {
                 // -20 형태
-                int num = parse_number(argv[i] + 1);
-                if (num == -1) return -1;
-                opts->num_lines = num;
+                if (set_count(opts, argv[i] + 1, 0) == -1) return -1;
             }
             continue;
         }
@@ -236,9 +422,7 @@ int parse_options(int argc, char *argv[], head_options *opts, int *file_start) {
                 case 'n':
                     if (argv[i][j + 1] != '\0') {
                         // -n20 형태
-                        int num = parse_number(argv[i] + j + 1);
-                        if (num == -1) return -1;
-                        opts->num_lines = num;
+                        if (set_count(opts, argv[i] + j + 1, 0) == -1) return -1;
                         j = strlen(argv[i]) - 1; // 루프 종료
                     } else {
                         // -n 20 형태
@@ -246,9 +430,23 @@ int parse_options(int argc, char *argv[], head_options *opts, int *file_start) {
                             fprintf(stderr, "head: option requires an argument -- 'n'\n");
                             return -1;
                         }
-                        int num = parse_number(argv[i + 1]);
-                        if (num == -1) return -1;
-                        opts->num_lines = num;
+                        if (set_count(opts, argv[i + 1], 0) == -1) return -1;
+                        i++; // 다음 인수 건너뛰기
+                        j = strlen(argv[i]) - 1; // 루프 종료
+                    }
+                    break;
+                case 'c':
+                    if (argv[i][j + 1] != '\0') {
+                        // -c20 형태
+                        if (set_count(opts, argv[i] + j + 1, 1) == -1) return -1;
+                        j = strlen(argv[i]) - 1; // 루프 종료
+                    } else {
+                        // -c 20 형태
+                        if (i + 1 >= argc) {
+                            fprintf(stderr, "head: option requires an argument -- 'c'\n");
+                            return -1;
+                        }
+                        if (set_count(opts, argv[i + 1], 1) == -1) return -1;
                         i++; // 다음 인수 건너뛰기
                         j = strlen(argv[i]) - 1; // 루프 종료
                     }
@@ -314,7 +512,8 @@ int main(int argc, char *argv[]) {
                 if (!is_first_file) {
                     printf("\n");
                 }
-                printf("==> %s <==\n", argv[i]);
+                printf("==> %s <==\n", strcmp(argv[i], "-") == 0 ? "standard input" : argv[i]);
+                fflush(stdout);   // 본문은 write로 직접 출력하므로 순서 유지
             }
             
             // 파일 처리
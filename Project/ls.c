@@ -1,14 +1,37 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <dirent.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/syscall.h>
 #include <pwd.h>
 #include <grp.h>
 #include <time.h>
 #include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#define GETDENTS_BUF_SIZE (256 * 1024)   // getdents64 한 번에 읽을 버퍼 크기
+#define ARENA_INIT_SIZE   (64 * 1024)    // 이름 아레나 초기 크기
+#define INSERTION_SORT_THRESHOLD 16     // 이 크기 이하 구간은 삽입 정렬
+#define OUT_BUF_SIZE      (64 * 1024)    // 표준 출력 버퍼 크기
+#define ID_CACHE_SIZE     256            // uid/gid 이름 캐시 슬롯 수
+#define TIME_CACHE_SIZE   256            // 분 단위 시간 문자열 캐시 슬롯 수
+#define MAX_BUFFERED_DIRS 4096           // 병렬 -R에서 출력 대기 중인 디렉토리 상한
+
+// 정렬 기준
+enum sort_mode {
+    SORT_NAME,      // 기본: 이름순 (바이트 비교, 로케일 무시)
+    SORT_TIME,      // -t: 수정 시간 최신순
+    SORT_SIZE,      // -S: 크기 큰 순
+    SORT_VERSION,   // -v: 자연 버전 순서 (file2 < file10)
+    SORT_NONE       // -U: 정렬하지 않고 읽는 즉시 출력
+};
 
 // 옵션 플래그 구조체
 struct ls_options {
@@ -16,31 +39,160 @@ struct ls_options {
     int long_format;     // -l 옵션
     int human_readable;  // -h 옵션
     int recursive;       // -R 옵션
+    enum sort_mode sort; // -t, -S, -v, -U 옵션
+    int jobs;            // -j 옵션 (병렬 -R 작업자 수)
+};
+
+// 커널이 돌려주는 getdents64 레코드 형식
+struct linux_dirent64 {
+    ino64_t        d_ino;
+    off64_t        d_off;
+    unsigned short d_reclen;
+    unsigned char  d_type;
+    char           d_name[];
+};
+
+// 파일 이름을 연속된 메모리에 모아두는 아레나
+struct name_arena {
+    char *buf;
+    size_t used;
+    size_t capacity;
 };
 
-// 파일 정보를 저장하는 구조체
+// 파일 정보를 저장하는 구조체 (이름은 아레나 오프셋으로만 보관)
 struct file_info {
-    char name[256];
-    struct stat st;
-    char *full_path;
+    size_t name_off;      // 아레나 내 이름 위치
+    unsigned char d_type; // getdents64가 알려준 파일 타입
+    unsigned char stat_ok;// stats[] 항목이 유효한지
+};
+
+// 정렬용 (키, 인덱스) 쌍 - 큰 레코드 대신 이것만 이동
+struct sort_key {
+    uint64_t key;   // 미리 계산한 기본 정렬 키
+    size_t idx;     // files[] 인덱스
+};
+
+// 한 디렉토리의 읽기 결과
+struct dir_listing {
+    int dirfd;                // 디렉토리 fd (readlinkat 용)
+    struct name_arena names;  // 이름 아레나
+    struct file_info *files;  // 항목 배열
+    struct stat *stats;       // stat이 필요한 경우에만 할당
+    struct sort_key *order;   // 정렬된 출력 순서
+    size_t count;
+    size_t capacity;
+};
+
+// 출력 버퍼 (fd >= 0이면 가득 찰 때 write, fd < 0이면 메모리에 계속 누적)
+struct out_buf {
+    int fd;
+    char *data;
+    size_t len;
+    size_t capacity;
+};
+
+// -l 출력의 열 너비
+struct column_widths {
+    int nlink;
+    int owner;
+    int group;
+    int size;
+};
+
+// uid/gid -> 이름 캐시 항목
+struct id_cache_entry {
+    unsigned int id;
+    char *name;
+};
+
+// 분 단위로 포맷한 시간 문자열 캐시 항목
+struct time_cache_entry {
+    long long minute;
+    int recent;
+    int valid;
+    char text[20];
+};
+
+// 병렬 -R에서 디렉토리 하나의 처리 상태
+enum node_state {
+    NODE_PENDING,
+    NODE_RUNNING,
+    NODE_DONE
+};
+
+// 병렬 -R의 디렉토리 노드: 출력 결과와 순서대로 정렬된 자식 목록
+struct dir_node {
+    char *path;
+    int depth;
+    enum node_state state;
+    int in_stack;                 // 작업 스택에 아직 포인터가 남아 있는지
+    int orphaned;                 // 출력이 끝나 작업자가 해제해야 하는지
+    struct out_buf output;        // 이 디렉토리의 출력 (메모리 버퍼)
+    struct dir_node **children;
+    size_t child_count;
+};
+
+// 병렬 -R 공유 상태
+struct parallel_ctx {
+    pthread_mutex_t lock;
+    pthread_cond_t work_cond;     // 작업 스택에 일이 생김 / 출력 대기량이 줄어듦
+    pthread_cond_t done_cond;     // 노드 처리 완료
+    struct dir_node **stack;      // 처리 대기 노드 (LIFO)
+    size_t stack_count;
+    size_t stack_capacity;
+    size_t buffered;              // 처리 완료 후 아직 출력되지 않은 노드 수
+    int finished;
+    struct ls_options *opts;
 };
 
 // 함수 선언
 void print_usage(const char *program_name);
 void parse_options(int argc, char *argv[], struct ls_options *opts, char **directory);
 void ls_directory(const char *path, struct ls_options *opts, int depth);
-int compare_files(const void *a, const void *b);
-void print_file_info(struct file_info *file, struct ls_options *opts);
-void print_permissions(mode_t mode);
-char *format_size(off_t size, int human_readable);
-char *format_time(time_t time);
+void list_one_directory(const char *path, struct ls_options *opts, int depth,
+                        struct out_buf *out, struct name_arena *subdirs, size_t *subdir_count);
+void parallel_ls(const char *path, struct ls_options *opts);
+int load_directory(const char *path, struct ls_options *opts, struct dir_listing *list);
+void free_listing(struct dir_listing *list);
+int need_stat(struct ls_options *opts);
+void stream_directory(const char *path, struct ls_options *opts, int depth);
+int is_subdirectory(int dirfd, const char *name, unsigned char d_type, struct stat *st);
+void sort_listing(struct dir_listing *list, enum sort_mode mode);
+int compare_files(const struct sort_key *a, const struct sort_key *b, struct dir_listing *list, enum sort_mode mode);
+int version_compare(const char *a, const char *b);
+void compute_widths(struct dir_listing *list, struct ls_options *opts, struct column_widths *w);
+void print_file_info(struct out_buf *out, int dirfd, const char *name, struct stat *st,
+                     struct ls_options *opts, const struct column_widths *w);
+void print_permissions(struct out_buf *out, mode_t mode);
+char *format_size(off_t size, int human_readable, char *result);
+const char *format_time(time_t mtime);
+const char *user_name(uid_t uid);
+const char *group_name(gid_t gid);
+void out_write(struct out_buf *out, const char *data, size_t len);
+void out_str(struct out_buf *out, const char *str);
+void out_flush(struct out_buf *out);
+static void write_all(int fd, const char *data, size_t len);
+
+static char stdout_data[OUT_BUF_SIZE];
+static struct out_buf stdout_buf = {STDOUT_FILENO, stdout_data, 0, OUT_BUF_SIZE};
+
+// 스트리밍 출력처럼 목록 전체를 볼 수 없을 때 쓰는 기본 열 너비
+static const struct column_widths default_widths = {2, 8, 8, 8};
+
+// 캐시는 스레드마다 따로 두어 병렬 -R에서도 락 없이 사용
+static __thread struct id_cache_entry uid_cache[ID_CACHE_SIZE];
+static __thread struct id_cache_entry gid_cache[ID_CACHE_SIZE];
+static __thread struct time_cache_entry time_cache[TIME_CACHE_SIZE];
+static time_t list_start_time;   // 최근 6개월 판단 기준 시각
 
 int main(int argc, char *argv[]) {
-    struct ls_options opts = {0, 0, 0, 0};
+    struct ls_options opts = {0, 0, 0, 0, SORT_NAME, 1};
     char *directory = ".";
     
     parse_options(argc, argv, &opts, &directory);
+    list_start_time = time(NULL);
     ls_directory(directory, &opts, 0);
+    out_flush(&stdout_buf);
     
     return 0;
 }
@@ -52,12 +204,17 @@ void print_usage(const char *program_name) {
     printf("  -l    상세 정보 표시\n");
     printf("  -h    사람이 읽기 쉬운 크기 형식\n");
     printf("  -R    하위 디렉토리 재귀적 나열\n");
+    printf("  -t    수정 시간순 정렬 (최신 먼저)\n");
+    printf("  -S    크기순 정렬 (큰 파일 먼저)\n");
+    printf("  -v    자연 버전 순서로 정렬\n");
+    printf("  -U    정렬하지 않고 읽는 순서대로 바로 출력\n");
+    printf("  -j N  -R에서 N개 스레드로 병렬 탐색 (0: CPU 수)\n");
 }
 
 void parse_options(int argc, char *argv[], struct ls_options *opts, char **directory) {
     int opt;
     
-    while ((opt = getopt(argc, argv, "alhR")) != -1) {
+    while ((opt = getopt(argc, argv, "alhRtSvUj:")) != -1) {
         switch (opt) {
             case 'a':
                 opts->show_all = 1;
@@ -71,6 +228,25 @@ void parse_options(int argc, char *argv[], struct ls_options *opts, char **direc
             case 'R':
                 opts->recursive = 1;
                 break;
+            case 't':
+                opts->sort = SORT_TIME;
+                break;
+            case 'S':
+                opts->sort = SORT_SIZE;
+                break;
+            case 'v':
+                opts->sort = SORT_VERSION;
+                break;
+            case 'U':
+                opts->sort = SORT_NONE;
+                break;
+            case 'j':
+                opts->jobs = atoi(optarg);
+                if (opts->jobs <= 0) {
+                    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+                    opts->jobs = cpus > 0 ? (int)cpus : 1;
+                }
+                break;
             default:
                 print_usage(argv[0]);
                 exit(EXIT_FAILURE);
@@ -83,149 +259,913 @@ void parse_options(int argc, char *argv[], struct ls_options *opts, char **direc
     }
 }
 
+// 출력 형식이나 정렬 기준이 stat 정보를 필요로 하는지
+int need_stat(struct ls_options *opts) {
+    return opts->long_format || opts->sort == SORT_TIME || opts->sort == SORT_SIZE;
+}
+
+// 아레나에 이름을 추가하고 오프셋을 돌려줌
+static int arena_add(struct name_arena *arena, const char *name, size_t *off) {
+    size_t len = strlen(name) + 1;
+
+    if (arena->used + len > arena->capacity) {
+        size_t new_cap = arena->capacity ? arena->capacity : ARENA_INIT_SIZE;
+        while (arena->used + len > new_cap) {
+            new_cap *= 2;
+        }
+        char *new_buf = realloc(arena->buf, new_cap);
+        if (new_buf == NULL) {
+            return -1;
+        }
+        arena->buf = new_buf;
+        arena->capacity = new_cap;
+    }
+
+    memcpy(arena->buf + arena->used, name, len);
+    *off = arena->used;
+    arena->used += len;
+    return 0;
+}
+
+// 항목 배열에 새 항목 추가
+static int listing_add(struct dir_listing *list, const char *name, unsigned char d_type) {
+    if (list->count >= list->capacity) {
+        size_t new_cap = list->capacity ? list->capacity * 2 : 64;
+        struct file_info *new_files = realloc(list->files, new_cap * sizeof(struct file_info));
+        if (new_files == NULL) {
+            return -1;
+        }
+        list->files = new_files;
+        list->capacity = new_cap;
+    }
+
+    struct file_info *file = &list->files[list->count];
+    if (arena_add(&list->names, name, &file->name_off) == -1) {
+        return -1;
+    }
+    file->d_type = d_type;
+    file->stat_ok = 0;
+    list->count++;
+    return 0;
+}
+
+static const char *file_name(struct dir_listing *list, size_t idx) {
+    return list->names.buf + list->files[idx].name_off;
+}
+
+// 디렉토리 항목을 getdents64로 한꺼번에 읽고, 필요한 경우에만 fstatat 수행
+int load_directory(const char *path, struct ls_options *opts, struct dir_listing *list) {
+    memset(list, 0, sizeof(*list));
+
+    list->dirfd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (list->dirfd == -1) {
+        perror(path);
+        return -1;
+    }
+
+    char *buf = malloc(GETDENTS_BUF_SIZE);
+    if (buf == NULL) {
+        perror("메모리 할당 실패");
+        close(list->dirfd);
+        return -1;
+    }
+
+    // 디렉토리 내 파일들 읽기
+    for (;;) {
+        long nread = syscall(SYS_getdents64, list->dirfd, buf, GETDENTS_BUF_SIZE);
+        if (nread == -1) {
+            perror(path);
+            break;
+        }
+        if (nread == 0) {
+            break;
+        }
+
+        for (long pos = 0; pos < nread; ) {
+            struct linux_dirent64 *d = (struct linux_dirent64 *)(buf + pos);
+            pos += d->d_reclen;
+
+            // 숨김 파일 처리
+            if (!opts->show_all && d->d_name[0] == '.') {
+                continue;
+            }
+
+            if (listing_add(list, d->d_name, d->d_type) == -1) {
+                perror("메모리 재할당 실패");
+                free(buf);
+                free_listing(list);
+                return -1;
+            }
+        }
+    }
+    free(buf);
+
+    // stat 정보는 출력 형식에 필요할 때만 가져오기
+    if (need_stat(opts) && list->count > 0) {
+        list->stats = malloc(list->count * sizeof(struct stat));
+        if (list->stats == NULL) {
+            perror("메모리 할당 실패");
+            free_listing(list);
+            return -1;
+        }
+        for (size_t i = 0; i < list->count; i++) {
+            if (fstatat(list->dirfd, file_name(list, i), &list->stats[i], AT_SYMLINK_NOFOLLOW) == -1) {
+                fprintf(stderr, "%s/%s: %s\n", path, file_name(list, i), strerror(errno));
+                continue;
+            }
+            list->files[i].stat_ok = 1;
+        }
+    }
+
+    // 미리 계산한 키로 정렬
+    list->order = malloc((list->count ? list->count : 1) * sizeof(struct sort_key));
+    if (list->order == NULL) {
+        perror("메모리 할당 실패");
+        free_listing(list);
+        return -1;
+    }
+    sort_listing(list, opts->sort);
+
+    return 0;
+}
+
+void free_listing(struct dir_listing *list) {
+    if (list->dirfd >= 0) {
+        close(list->dirfd);
+    }
+    free(list->names.buf);
+    free(list->files);
+    free(list->stats);
+    free(list->order);
+    memset(list, 0, sizeof(*list));
+    list->dirfd = -1;
+}
+
+// 재귀 대상인 하위 디렉토리인지 (심볼릭 링크는 따라가지 않음)
+int is_subdirectory(int dirfd, const char *name, unsigned char d_type, struct stat *st) {
+    if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) {
+        return 0;
+    }
+    if (st != NULL) {
+        return S_ISDIR(st->st_mode);
+    }
+    if (d_type != DT_UNKNOWN) {
+        return d_type == DT_DIR;
+    }
+
+    // d_type을 지원하지 않는 파일시스템에서는 fstatat으로 확인
+    struct stat tmp;
+    if (fstatat(dirfd, name, &tmp, AT_SYMLINK_NOFOLLOW) == -1) {
+        return 0;
+    }
+    return S_ISDIR(tmp.st_mode);
+}
+
 void ls_directory(const char *path, struct ls_options *opts, int depth) {
-    DIR *dir;
-    struct dirent *entry;
-    struct file_info *files = NULL;
-    int file_count = 0;
-    int capacity = 10;
-    
+    struct name_arena subdirs = {NULL, 0, 0};
+    size_t subdir_count = 0;
+
+    // 정렬하지 않는 경우 읽는 즉시 출력
+    if (opts->sort == SORT_NONE) {
+        stream_directory(path, opts, depth);
+        return;
+    }
+
+    // 여러 스레드로 하위 디렉토리를 미리 읽어두는 모드
+    if (opts->recursive && opts->jobs > 1 && depth == 0) {
+        parallel_ls(path, opts);
+        return;
+    }
+
+    list_one_directory(path, opts, depth, &stdout_buf, &subdirs, &subdir_count);
+
+    // 재귀 옵션이 활성화된 경우 하위 디렉토리 처리
+    char sub_path[PATH_MAX];
+    const char *name = subdirs.buf;
+    for (size_t i = 0; i < subdir_count; i++) {
+        snprintf(sub_path, sizeof(sub_path), "%s/%s", path, name);
+        ls_directory(sub_path, opts, depth + 1);
+        name += strlen(name) + 1;
+    }
+
+    // 메모리 해제
+    free(subdirs.buf);
+}
+
+// 디렉토리 하나를 읽어 out에 출력하고, 재귀할 하위 디렉토리 이름을 순서대로 subdirs에 담음
+void list_one_directory(const char *path, struct ls_options *opts, int depth,
+                        struct out_buf *out, struct name_arena *subdirs, size_t *subdir_count) {
+    struct dir_listing list;
+
     // 재귀 호출 시 디렉토리 경로 출력
     if (opts->recursive && depth > 0) {
-        printf("\n%s:\n", path);
+        out_str(out, "\n");
+        out_str(out, path);
+        out_str(out, ":\n");
     }
-    
-    dir = opendir(path);
-    if (dir == NULL) {
+
+    if (load_directory(path, opts, &list) == -1) {
+        return;
+    }
+
+    // 파일 정보 출력
+    struct column_widths widths;
+    compute_widths(&list, opts, &widths);
+    for (size_t i = 0; i < list.count; i++) {
+        size_t idx = list.order[i].idx;
+        if (need_stat(opts) && !list.files[idx].stat_ok) {
+            continue;
+        }
+        print_file_info(out, list.dirfd, file_name(&list, idx),
+                        list.stats ? &list.stats[idx] : NULL, opts, &widths);
+    }
+
+    // 재귀 옵션이 활성화된 경우 하위 디렉토리 이름 수집
+    if (opts->recursive) {
+        for (size_t i = 0; i < list.count; i++) {
+            size_t idx = list.order[i].idx;
+            if (need_stat(opts) && !list.files[idx].stat_ok) {
+                continue;
+            }
+            if (!is_subdirectory(list.dirfd, file_name(&list, idx), list.files[idx].d_type,
+                                 list.stats ? &list.stats[idx] : NULL)) {
+                continue;
+            }
+            size_t off;
+            if (arena_add(subdirs, file_name(&list, idx), &off) == -1) {
+                perror("메모리 재할당 실패");
+                break;
+            }
+            (*subdir_count)++;
+        }
+    }
+
+    // 메모리 해제
+    free_listing(&list);
+}
+
+// 작업자 스레드가 디렉토리 노드 하나를 처리: 출력 버퍼 작성 후 자식 노드 생성
+static void process_node(struct dir_node *node, struct ls_options *opts) {
+    struct name_arena subdirs = {NULL, 0, 0};
+    size_t subdir_count = 0;
+
+    list_one_directory(node->path, opts, node->depth, &node->output, &subdirs, &subdir_count);
+
+    if (subdir_count > 0) {
+        node->children = calloc(subdir_count, sizeof(struct dir_node *));
+        if (node->children == NULL) {
+            perror("메모리 할당 실패");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    const char *name = subdirs.buf;
+    for (size_t i = 0; i < subdir_count; i++) {
+        struct dir_node *child = calloc(1, sizeof(struct dir_node));
+        size_t path_len = strlen(node->path) + strlen(name) + 2;
+        if (child == NULL || (child->path = malloc(path_len)) == NULL) {
+            perror("메모리 할당 실패");
+            exit(EXIT_FAILURE);
+        }
+        snprintf(child->path, path_len, "%s/%s", node->path, name);
+        child->depth = node->depth + 1;
+        child->output.fd = -1;
+        node->children[i] = child;
+        name += strlen(name) + 1;
+    }
+    node->child_count = subdir_count;
+    free(subdirs.buf);
+}
+
+// 처리가 끝난 노드를 완료로 표시하고 자식들을 작업 스택에 넣음 (락을 잡은 상태에서 호출)
+static void finish_node_locked(struct parallel_ctx *ctx, struct dir_node *node) {
+    node->state = NODE_DONE;
+    ctx->buffered++;
+
+    // 출력 순서와 가깝게 처리되도록 역순으로 쌓음 (첫 자식이 맨 위)
+    for (size_t i = node->child_count; i-- > 0; ) {
+        if (ctx->stack_count >= ctx->stack_capacity) {
+            size_t new_cap = ctx->stack_capacity ? ctx->stack_capacity * 2 : 256;
+            struct dir_node **new_stack = realloc(ctx->stack, new_cap * sizeof(struct dir_node *));
+            if (new_stack == NULL) {
+                perror("메모리 재할당 실패");
+                exit(EXIT_FAILURE);
+            }
+            ctx->stack = new_stack;
+            ctx->stack_capacity = new_cap;
+        }
+        node->children[i]->in_stack = 1;
+        ctx->stack[ctx->stack_count++] = node->children[i];
+    }
+
+    pthread_cond_broadcast(&ctx->done_cond);
+    pthread_cond_broadcast(&ctx->work_cond);
+}
+
+static void free_node(struct dir_node *node) {
+    free(node->path);
+    free(node->output.data);
+    free(node->children);
+    free(node);
+}
+
+static void *ls_worker(void *arg) {
+    struct parallel_ctx *ctx = arg;
+
+    pthread_mutex_lock(&ctx->lock);
+    for (;;) {
+        // 출력 대기 중인 버퍼가 너무 많으면 출력 스레드가 따라올 때까지 대기
+        while (!ctx->finished && (ctx->stack_count == 0 || ctx->buffered >= MAX_BUFFERED_DIRS)) {
+            pthread_cond_wait(&ctx->work_cond, &ctx->lock);
+        }
+        if (ctx->finished) {
+            break;
+        }
+
+        struct dir_node *node = ctx->stack[--ctx->stack_count];
+        node->in_stack = 0;
+
+        // 출력 스레드가 이미 직접 처리했거나 처리 후 버린 노드
+        if (node->state != NODE_PENDING) {
+            if (node->orphaned) {
+                free_node(node);
+            }
+            continue;
+        }
+
+        node->state = NODE_RUNNING;
+        pthread_mutex_unlock(&ctx->lock);
+        process_node(node, ctx->opts);
+        pthread_mutex_lock(&ctx->lock);
+        finish_node_locked(ctx, node);
+    }
+    pthread_mutex_unlock(&ctx->lock);
+    return NULL;
+}
+
+// 순차 버전과 같은 순서(전위 순회)로 노드 출력
+static void print_node(struct parallel_ctx *ctx, struct dir_node *node) {
+    pthread_mutex_lock(&ctx->lock);
+    if (node->state == NODE_PENDING) {
+        // 아직 아무도 집어가지 않았으면 직접 처리 (작업자가 모두 대기 중이어도 진행 보장)
+        node->state = NODE_RUNNING;
+        pthread_mutex_unlock(&ctx->lock);
+        process_node(node, ctx->opts);
+        pthread_mutex_lock(&ctx->lock);
+        finish_node_locked(ctx, node);
+    }
+    while (node->state != NODE_DONE) {
+        pthread_cond_wait(&ctx->done_cond, &ctx->lock);
+    }
+    pthread_mutex_unlock(&ctx->lock);
+
+    out_write(&stdout_buf, node->output.data, node->output.len);
+    free(node->output.data);
+    node->output.data = NULL;
+
+    pthread_mutex_lock(&ctx->lock);
+    ctx->buffered--;
+    pthread_cond_broadcast(&ctx->work_cond);
+    pthread_mutex_unlock(&ctx->lock);
+
+    for (size_t i = 0; i < node->child_count; i++) {
+        print_node(ctx, node->children[i]);
+    }
+
+    // 작업 스택에 아직 남아 있으면 꺼내는 작업자가 해제
+    pthread_mutex_lock(&ctx->lock);
+    if (node->in_stack) {
+        node->orphaned = 1;
+        node = NULL;
+    }
+    pthread_mutex_unlock(&ctx->lock);
+    if (node != NULL) {
+        free_node(node);
+    }
+}
+
+// -R -j N: 작업자 스레드가 하위 디렉토리를 병렬로 읽고, 출력 스레드가 순서대로 내보냄
+void parallel_ls(const char *path, struct ls_options *opts) {
+    struct parallel_ctx ctx;
+    pthread_t *threads;
+    int nthreads = opts->jobs;
+
+    memset(&ctx, 0, sizeof(ctx));
+    pthread_mutex_init(&ctx.lock, NULL);
+    pthread_cond_init(&ctx.work_cond, NULL);
+    pthread_cond_init(&ctx.done_cond, NULL);
+    ctx.opts = opts;
+
+    struct dir_node *root = calloc(1, sizeof(struct dir_node));
+    if (root == NULL || (root->path = strdup(path)) == NULL) {
+        perror("메모리 할당 실패");
+        exit(EXIT_FAILURE);
+    }
+    root->output.fd = -1;
+
+    threads = malloc(nthreads * sizeof(pthread_t));
+    if (threads == NULL) {
+        perror("메모리 할당 실패");
+        exit(EXIT_FAILURE);
+    }
+    int started = 0;
+    for (; started < nthreads; started++) {
+        if (pthread_create(&threads[started], NULL, ls_worker, &ctx) != 0) {
+            break;
+        }
+    }
+
+    print_node(&ctx, root);
+
+    pthread_mutex_lock(&ctx.lock);
+    ctx.finished = 1;
+    pthread_cond_broadcast(&ctx.work_cond);
+    pthread_mutex_unlock(&ctx.lock);
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    free(threads);
+    free(ctx.stack);
+    pthread_mutex_destroy(&ctx.lock);
+    pthread_cond_destroy(&ctx.work_cond);
+    pthread_cond_destroy(&ctx.done_cond);
+}
+
+// -U: getdents64 결과를 받는 즉시 출력하고, 재귀할 하위 디렉토리 이름만 보관
+void stream_directory(const char *path, struct ls_options *opts, int depth) {
+    struct name_arena subdirs = {NULL, 0, 0};
+    size_t subdir_count = 0;
+    struct stat st;
+
+    // 재귀 호출 시 디렉토리 경로 출력
+    if (opts->recursive && depth > 0) {
+        out_str(&stdout_buf, "\n");
+        out_str(&stdout_buf, path);
+        out_str(&stdout_buf, ":\n");
+    }
+
+    int dirfd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirfd == -1) {
         perror(path);
         return;
     }
-    
-    // 파일 정보 저장을 위한 동적 배열 할당
-    files = malloc(capacity * sizeof(struct file_info));
-    if (files == NULL) {
+
+    char *buf = malloc(GETDENTS_BUF_SIZE);
+    if (buf == NULL) {
         perror("메모리 할당 실패");
-        closedir(dir);
+        close(dirfd);
         return;
     }
-    
-    // 디렉토리 내 파일들 읽기
-    while ((entry = readdir(dir)) != NULL) {
-        // 숨김 파일 처리
-        if (!opts->show_all && entry->d_name[0] == '.') {
-            continue;
+
+    for (;;) {
+        long nread = syscall(SYS_getdents64, dirfd, buf, GETDENTS_BUF_SIZE);
+        if (nread == -1) {
+            perror(path);
+            break;
         }
-        
-        // 배열 크기 확장
-        if (file_count >= capacity) {
-            capacity *= 2;
-            files = realloc(files, capacity * sizeof(struct file_info));
-            if (files == NULL) {
-                perror("메모리 재할당 실패");
-                closedir(dir);
-                return;
+        if (nread == 0) {
+            break;
+        }
+
+        for (long pos = 0; pos < nread; ) {
+            struct linux_dirent64 *d = (struct linux_dirent64 *)(buf + pos);
+            pos += d->d_reclen;
+
+            // 숨김 파일 처리
+            if (!opts->show_all && d->d_name[0] == '.') {
+                continue;
+            }
+
+            struct stat *stp = NULL;
+            if (need_stat(opts)) {
+                if (fstatat(dirfd, d->d_name, &st, AT_SYMLINK_NOFOLLOW) == -1) {
+                    fprintf(stderr, "%s/%s: %s\n", path, d->d_name, strerror(errno));
+                    continue;
+                }
+                stp = &st;
+            }
+            print_file_info(&stdout_buf, dirfd, d->d_name, stp, opts, &default_widths);
+
+            if (opts->recursive && is_subdirectory(dirfd, d->d_name, d->d_type, stp)) {
+                size_t off;
+                if (arena_add(&subdirs, d->d_name, &off) == -1) {
+                    perror("메모리 재할당 실패");
+                    break;
+                }
+                subdir_count++;
             }
         }
-        
-        // 파일 정보 저장
-        strcpy(files[file_count].name, entry->d_name);
-        
-        // 전체 경로 생성
-        int path_len = strlen(path) + strlen(entry->d_name) + 2;
-        files[file_count].full_path = malloc(path_len);
-        snprintf(files[file_count].full_path, path_len, "%s/%s", path, entry->d_name);
-        
-        // stat 정보 가져오기
-        if (stat(files[file_count].full_path, &files[file_count].st) == -1) {
-            perror(files[file_count].full_path);
-            free(files[file_count].full_path);
+    }
+
+    free(buf);
+    close(dirfd);
+
+    // 읽은 순서대로 하위 디렉토리 처리
+    char sub_path[PATH_MAX];
+    const char *name = subdirs.buf;
+    for (size_t i = 0; i < subdir_count; i++) {
+        snprintf(sub_path, sizeof(sub_path), "%s/%s", path, name);
+        stream_directory(sub_path, opts, depth + 1);
+        name += strlen(name) + 1;
+    }
+    free(subdirs.buf);
+}
+
+// 이름 앞 8바이트를 빅엔디언 정수로 묶음 (짧은 이름은 0으로 채움)
+static uint64_t name_prefix_key(const char *name) {
+    uint64_t key = 0;
+    int i = 0;
+
+    for (; i < 8 && name[i] != '\0'; i++) {
+        key = (key << 8) | (unsigned char)name[i];
+    }
+    return key << (8 * (8 - i));
+}
+
+// 버전 정렬 키: 첫 숫자 앞까지의 바이트, 숫자 자리는 '0' 표식 하나로 대체
+static uint64_t version_prefix_key(const char *name) {
+    uint64_t key = 0;
+    int i = 0;
+
+    for (; i < 8 && name[i] != '\0'; i++) {
+        if (name[i] >= '0' && name[i] <= '9') {
+            key = (key << 8) | '0';
+            i++;
+            break;
+        }
+        key = (key << 8) | (unsigned char)name[i];
+    }
+    return key << (8 * (8 - i));
+}
+
+// 부호 있는 값을 부호 없는 정렬 순서로 바꾼 뒤 뒤집음 (큰 값이 먼저)
+static uint64_t descending_key(int64_t value) {
+    return ~((uint64_t)value ^ (1ULL << 63));
+}
+
+int compare_files(const struct sort_key *a, const struct sort_key *b, struct dir_listing *list, enum sort_mode mode) {
+    if (a->key != b->key) {
+        return a->key < b->key ? -1 : 1;
+    }
+
+    const char *name_a = file_name(list, a->idx);
+    const char *name_b = file_name(list, b->idx);
+
+    if (mode == SORT_VERSION) {
+        int cmp = version_compare(name_a, name_b);
+        return cmp != 0 ? cmp : strcmp(name_a, name_b);
+    }
+    if (mode == SORT_TIME) {
+        long ns_a = list->stats[a->idx].st_mtim.tv_nsec;
+        long ns_b = list->stats[b->idx].st_mtim.tv_nsec;
+        if (ns_a != ns_b) {
+            return ns_a > ns_b ? -1 : 1;
+        }
+    }
+    return strcmp(name_a, name_b);
+}
+
+// 숫자 구간은 수치로, 나머지는 바이트 단위로 비교
+int version_compare(const char *a, const char *b) {
+    while (*a != '\0' && *b != '\0') {
+        int digit_a = *a >= '0' && *a <= '9';
+        int digit_b = *b >= '0' && *b <= '9';
+
+        if (digit_a && digit_b) {
+            // 앞의 0을 건너뛰고 자릿수, 그다음 사전순으로 비교
+            while (*a == '0') a++;
+            while (*b == '0') b++;
+            const char *start_a = a, *start_b = b;
+            while (*a >= '0' && *a <= '9') a++;
+            while (*b >= '0' && *b <= '9') b++;
+            size_t len_a = a - start_a, len_b = b - start_b;
+            if (len_a != len_b) {
+                return len_a < len_b ? -1 : 1;
+            }
+            int cmp = memcmp(start_a, start_b, len_a);
+            if (cmp != 0) {
+                return cmp;
+            }
             continue;
         }
-        
-        file_count++;
+        if (*a != *b) {
+            return (unsigned char)*a < (unsigned char)*b ? -1 : 1;
+        }
+        a++;
+        b++;
     }
-    
-    closedir(dir);
-    
-    // 파일명으로 정렬
-    qsort(files, file_count, sizeof(struct file_info), compare_files);
-    
-    // 파일 정보 출력
-    for (int i = 0; i < file_count; i++) {
-        print_file_info(&files[i], opts);
+    if (*a == *b) {
+        return 0;
     }
-    
-    // 재귀 옵션이 활성화된 경우 하위 디렉토리 처리
-    if (opts->recursive) {
-        for (int i = 0; i < file_count; i++) {
-            if (S_ISDIR(files[i].st.st_mode) && 
-                strcmp(files[i].name, ".") != 0 && 
-                strcmp(files[i].name, "..") != 0) {
-                ls_directory(files[i].full_path, opts, depth + 1);
+    return *a == '\0' ? -1 : 1;
+}
+
+static void swap_keys(struct sort_key *a, struct sort_key *b) {
+    struct sort_key tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+static void sift_down(struct sort_key *keys, size_t start, size_t n, struct dir_listing *list, enum sort_mode mode) {
+    size_t root = start;
+
+    while (2 * root + 1 < n) {
+        size_t child = 2 * root + 1;
+        if (child + 1 < n && compare_files(&keys[child], &keys[child + 1], list, mode) < 0) {
+            child++;
+        }
+        if (compare_files(&keys[root], &keys[child], list, mode) >= 0) {
+            return;
+        }
+        swap_keys(&keys[root], &keys[child]);
+        root = child;
+    }
+}
+
+static void heap_sort(struct sort_key *keys, size_t n, struct dir_listing *list, enum sort_mode mode) {
+    for (size_t i = n / 2; i-- > 0; ) {
+        sift_down(keys, i, n, list, mode);
+    }
+    for (size_t end = n; end-- > 1; ) {
+        swap_keys(&keys[0], &keys[end]);
+        sift_down(keys, 0, end, list, mode);
+    }
+}
+
+// 인트로소트: 퀵소트 + 재귀 깊이 초과 시 힙소트, 작은 구간은 마지막에 삽입 정렬
+static void intro_sort(struct sort_key *keys, size_t n, int depth_limit, struct dir_listing *list, enum sort_mode mode) {
+    while (n > INSERTION_SORT_THRESHOLD) {
+        if (depth_limit-- == 0) {
+            heap_sort(keys, n, list, mode);
+            return;
+        }
+
+        // 세 값의 중앙값을 피벗으로
+        size_t mid = n / 2;
+        if (compare_files(&keys[mid], &keys[0], list, mode) < 0) swap_keys(&keys[mid], &keys[0]);
+        if (compare_files(&keys[n - 1], &keys[0], list, mode) < 0) swap_keys(&keys[n - 1], &keys[0]);
+        if (compare_files(&keys[n - 1], &keys[mid], list, mode) < 0) swap_keys(&keys[n - 1], &keys[mid]);
+        struct sort_key pivot = keys[mid];
+
+        size_t i = 0, j = n - 1;
+        for (;;) {
+            while (compare_files(&keys[i], &pivot, list, mode) < 0) i++;
+            while (compare_files(&pivot, &keys[j], list, mode) < 0) j--;
+            if (i >= j) {
+                break;
+            }
+            swap_keys(&keys[i], &keys[j]);
+            i++;
+            j--;
+        }
+
+        // 작은 쪽은 재귀, 큰 쪽은 반복
+        size_t left = j + 1;
+        if (left < n - left) {
+            intro_sort(keys, left, depth_limit, list, mode);
+            keys += left;
+            n -= left;
+        } else {
+            intro_sort(keys + left, n - left, depth_limit, list, mode);
+            n = left;
+        }
+    }
+}
+
+static void insertion_sort(struct sort_key *keys, size_t n, struct dir_listing *list, enum sort_mode mode) {
+    for (size_t i = 1; i < n; i++) {
+        struct sort_key cur = keys[i];
+        size_t j = i;
+        while (j > 0 && compare_files(&cur, &keys[j - 1], list, mode) < 0) {
+            keys[j] = keys[j - 1];
+            j--;
+        }
+        keys[j] = cur;
+    }
+}
+
+// 정렬 키를 미리 계산한 뒤 (키, 인덱스) 쌍만 정렬
+void sort_listing(struct dir_listing *list, enum sort_mode mode) {
+    for (size_t i = 0; i < list->count; i++) {
+        struct sort_key *k = &list->order[i];
+        k->idx = i;
+
+        switch (mode) {
+            case SORT_TIME:
+                k->key = list->files[i].stat_ok ? descending_key(list->stats[i].st_mtim.tv_sec) : 0;
+                break;
+            case SORT_SIZE:
+                k->key = list->files[i].stat_ok ? descending_key(list->stats[i].st_size) : 0;
+                break;
+            case SORT_VERSION:
+                k->key = version_prefix_key(file_name(list, i));
+                break;
+            default:
+                k->key = name_prefix_key(file_name(list, i));
+                break;
+        }
+    }
+
+    int depth_limit = 0;
+    for (size_t n = list->count; n > 1; n >>= 1) {
+        depth_limit += 2;
+    }
+    intro_sort(list->order, list->count, depth_limit, list, mode);
+    insertion_sort(list->order, list->count, list, mode);
+}
+
+// 출력 버퍼에 바이트 추가 (fd가 있으면 가득 찰 때 write, 없으면 확장)
+void out_write(struct out_buf *out, const char *data, size_t len) {
+    if (out->len + len > out->capacity) {
+        if (out->fd >= 0) {
+            out_flush(out);
+            if (len > out->capacity) {
+                write_all(out->fd, data, len);
+                return;
+            }
+        } else {
+            size_t new_cap = out->capacity ? out->capacity : OUT_BUF_SIZE;
+            while (out->len + len > new_cap) {
+                new_cap *= 2;
+            }
+            char *new_data = realloc(out->data, new_cap);
+            if (new_data == NULL) {
+                perror("메모리 재할당 실패");
+                exit(EXIT_FAILURE);
             }
+            out->data = new_data;
+            out->capacity = new_cap;
         }
     }
-    
-    // 메모리 해제
-    for (int i = 0; i < file_count; i++) {
-        free(files[i].full_path);
+    memcpy(out->data + out->len, data, len);
+    out->len += len;
+}
+
+void out_str(struct out_buf *out, const char *str) {
+    out_write(out, str, strlen(str));
+}
+
+// 폭에 맞춰 공백을 채워 출력 (left_align이면 왼쪽 정렬)
+static void out_padded(struct out_buf *out, const char *str, int width, int left_align) {
+    static const char spaces[] = "                                ";
+    int len = strlen(str);
+    int pad = width > len ? width - len : 0;
+
+    if (left_align) {
+        out_write(out, str, len);
+    }
+    while (pad > 0) {
+        int chunk = pad < (int)sizeof(spaces) - 1 ? pad : (int)sizeof(spaces) - 1;
+        out_write(out, spaces, chunk);
+        pad -= chunk;
+    }
+    if (!left_align) {
+        out_write(out, str, len);
     }
-    free(files);
 }
 
-int compare_files(const void *a, const void *b) {
-    struct file_info *file_a = (struct file_info *)a;
-    struct file_info *file_b = (struct file_info *)b;
-    return strcmp(file_a->name, file_b->name);
+void out_flush(struct out_buf *out) {
+    if (out->fd >= 0 && out->len > 0) {
+        write_all(out->fd, out->data, out->len);
+    }
+    out->len = 0;
 }
 
-void print_file_info(struct file_info *file, struct ls_options *opts) {
+static void write_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t written = write(fd, data, len);
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("write");
+            exit(EXIT_FAILURE);
+        }
+        data += written;
+        len -= written;
+    }
+}
+
+// uid/gid -> 이름 캐시 조회 (NSS 조회는 처음 보는 id에 대해서만)
+static const char *cached_id_name(struct id_cache_entry *cache, unsigned int id, int is_group) {
+    struct id_cache_entry *entry = &cache[id % ID_CACHE_SIZE];
+
+    if (entry->name != NULL && entry->id == id) {
+        return entry->name;
+    }
+
+    // 작업자 스레드에서도 호출되므로 재진입 가능한 _r 버전 사용
+    const char *name = NULL;
+    char buf[4096];
+    if (is_group) {
+        struct group gr, *result = NULL;
+        getgrgid_r(id, &gr, buf, sizeof(buf), &result);
+        name = result ? result->gr_name : NULL;
+    } else {
+        struct passwd pw, *result = NULL;
+        getpwuid_r(id, &pw, buf, sizeof(buf), &result);
+        name = result ? result->pw_name : NULL;
+    }
+
+    char *copy = strdup(name ? name : "unknown");
+    if (copy == NULL) {
+        return "unknown";
+    }
+    free(entry->name);
+    entry->id = id;
+    entry->name = copy;
+    return entry->name;
+}
+
+const char *user_name(uid_t uid) {
+    return cached_id_name(uid_cache, uid, 0);
+}
+
+const char *group_name(gid_t gid) {
+    return cached_id_name(gid_cache, gid, 1);
+}
+
+// 목록 전체에 대한 열 너비 계산 (기존 최소 너비 유지)
+void compute_widths(struct dir_listing *list, struct ls_options *opts, struct column_widths *w) {
+    char buf[32];
+
+    *w = default_widths;
+    if (!opts->long_format) {
+        return;
+    }
+
+    for (size_t i = 0; i < list->count; i++) {
+        if (!list->files[i].stat_ok) {
+            continue;
+        }
+        struct stat *st = &list->stats[i];
+        int len;
+
+        len = snprintf(buf, sizeof(buf), "%ld", (long)st->st_nlink);
+        if (len > w->nlink) w->nlink = len;
+        len = strlen(user_name(st->st_uid));
+        if (len > w->owner) w->owner = len;
+        len = strlen(group_name(st->st_gid));
+        if (len > w->group) w->group = len;
+        len = strlen(format_size(st->st_size, opts->human_readable, buf));
+        if (len > w->size) w->size = len;
+    }
+}
+
+void print_file_info(struct out_buf *out, int dirfd, const char *name, struct stat *st,
+                     struct ls_options *opts, const struct column_widths *w) {
     if (opts->long_format) {
+        char buf[32];
+
         // 권한 출력
-        print_permissions(file->st.st_mode);
-        
+        print_permissions(out, st->st_mode);
+
         // 링크 수
-        printf(" %2ld", file->st.st_nlink);
-        
+        snprintf(buf, sizeof(buf), "%ld", (long)st->st_nlink);
+        out_write(out, " ", 1);
+        out_padded(out, buf, w->nlink, 0);
+
         // 소유자
-        struct passwd *pw = getpwuid(file->st.st_uid);
-        printf(" %-8s", pw ? pw->pw_name : "unknown");
-        
+        out_write(out, " ", 1);
+        out_padded(out, user_name(st->st_uid), w->owner, 1);
+
         // 그룹
-        struct group *gr = getgrgid(file->st.st_gid);
-        printf(" %-8s", gr ? gr->gr_name : "unknown");
-        
+        out_write(out, " ", 1);
+        out_padded(out, group_name(st->st_gid), w->group, 1);
+
         // 크기
-        char *size_str = format_size(file->st.st_size, opts->human_readable);
-        printf(" %8s", size_str);
-        free(size_str);
-        
+        out_write(out, " ", 1);
+        out_padded(out, format_size(st->st_size, opts->human_readable, buf), w->size, 0);
+
         // 수정 시간
-        char *time_str = format_time(file->st.st_mtime);
-        printf(" %s", time_str);
-        free(time_str);
-        
+        out_write(out, " ", 1);
+        out_str(out, format_time(st->st_mtime));
+
         // 파일명
-        printf(" %s", file->name);
-        
+        out_write(out, " ", 1);
+        out_str(out, name);
+
         // 심볼릭 링크인 경우 링크 대상 표시
-        if (S_ISLNK(file->st.st_mode)) {
-            char link_target[256];
-            ssize_t len = readlink(file->full_path, link_target, sizeof(link_target) - 1);
+        if (S_ISLNK(st->st_mode)) {
+            char link_target[PATH_MAX];
+            ssize_t len = readlinkat(dirfd, name, link_target, sizeof(link_target) - 1);
             if (len != -1) {
-                link_target[len] = '\0';
-                printf(" -> %s", link_target);
+                out_write(out, " -> ", 4);
+                out_write(out, link_target, len);
             }
         }
-        
-        printf("\n");
+
+        out_write(out, "\n", 1);
     } else {
         // 간단한 형식으로 출력
-        printf("%s\n", file->name);
+        out_str(out, name);
+        out_write(out, "\n", 1);
     }
 }
 
-void print_permissions(mode_t mode) {
+void print_permissions(struct out_buf *out, mode_t mode) {
     char perms[11] = "----------";
     
     // 파일 타입
@@ -251,12 +1191,11 @@ void print_permissions(mode_t mode) {
     if (mode & S_IWOTH) perms[8] = 'w';
     if (mode & S_IXOTH) perms[9] = 'x';
     
-    printf("%s", perms);
+    out_write(out, perms, 10);
 }
 
-char *format_size(off_t size, int human_readable) {
-    char *result = malloc(20);
-    
+// result는 최소 20바이트
+char *format_size(off_t size, int human_readable, char *result) {
     if (human_readable && size >= 1024) {
         const char *units[] = {"B", "K", "M", "G", "T"};
         int unit = 0;
@@ -279,19 +1218,31 @@ char *format_size(off_t size, int human_readable) {
     return result;
 }
 
-char *format_time(time_t time) {
-    char *result = malloc(20);
-    struct tm *tm_info = localtime(&time);
-    
+// 같은 분(minute)에 속한 시각은 한 번만 strftime
+const char *format_time(time_t mtime) {
     // 현재 시간과 비교하여 6개월 이내면 시간 표시, 아니면 연도 표시
-    time_t now = time(time);
-    time_t six_months_ago = now - (6 * 30 * 24 * 60 * 60);
-    
-    if (time > six_months_ago && time <= now) {
-        strftime(result, 20, "%b %d %H:%M", tm_info);
+    time_t six_months_ago = list_start_time - (6 * 30 * 24 * 60 * 60);
+    int recent = mtime > six_months_ago && mtime <= list_start_time;
+    long long minute = (long long)(mtime >= 0 ? mtime / 60 : (mtime - 59) / 60);
+    struct time_cache_entry *entry = &time_cache[(unsigned long long)(minute * 2 + recent) % TIME_CACHE_SIZE];
+
+    if (entry->valid && entry->minute == minute && entry->recent == recent) {
+        return entry->text;
+    }
+
+    struct tm tm_info;
+    localtime_r(&mtime, &tm_info);
+    if (recent) {
+        strftime(entry->text, sizeof(entry->text), "%b %d %H:%M", &tm_info);
     } else {
-        strftime(result, 20, "%b %d  %Y", tm_info);
+        strftime(entry->text, sizeof(entry->text), "%b %d  %Y", &tm_info);
     }
+    entry->minute = minute;
+    entry->recent = recent;
+    entry->valid = 1;
     
-    return result;
-}
\ No newline at end of file
+    return entry->text;
+}
+
+// 컴파일 방법:
+// gcc -o ls ls.c -pthread
\ No newline at end of file
@@ -1,29 +1,98 @@
+#define _GNU_SOURCE
 #include <stdio.h>
+#include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <termios.h>
 #include <sys/ioctl.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/inotify.h>
+#include <fcntl.h>
 #include <errno.h>
 #include <signal.h>
+#include <pthread.h>
+#include <regex.h>
+#include <poll.h>
+#include <time.h>
+#include <stdint.h>
 
-#define MAX_LINE_LENGTH 1024
 #define DEFAULT_LINES 24
 #define DEFAULT_COLS 80
+#define INDEX_STRIDE 1024           // 줄 인덱스에 기록하는 간격 (줄 수)
+#define INDEX_CHUNK (4 * 1024 * 1024)  // 인덱서가 잠금을 잡고 한 번에 훑는 크기
+#define READ_CHUNK (64 * 1024)      // 표준입력을 한 번에 읽는 크기
+#define SEARCH_CHUNK (1024 * 1024)  // 검색 스레드가 한 번에 훑는 크기
+#define MAX_HIGHLIGHTS 64           // 한 줄에서 강조하는 최대 일치 수
+#define FOLLOW_POLL_MS 250          // inotify를 쓸 수 없을 때 따라가기 폴링 간격
+
+// 검색 상태 (패턴은 파일이 바뀌어도 유지, 일치 위치 캐시는 파일마다 새로 만듦)
+typedef struct {
+    char *pattern;
+    size_t pattern_len;
+    int literal;            // 정규식 메타 문자가 없으면 memmem으로 찾음
+    regex_t regex;
+    int regex_ok;
+    int direction;          // 마지막 검색 방향 (1: '/', -1: '?')
+    
+    // 일치 위치 캐시: [covered_lo, covered_hi) 구간을 검색했고 그 안의 일치 줄 시작 위치를 정렬해 보관
+    size_t *matches;
+    size_t match_count;
+    size_t match_capacity;
+    size_t covered_lo;
+    size_t covered_hi;
+    
+    // 검색 스레드 (index_lock으로 보호)
+    pthread_t thread;
+    int joinable;
+    int running;
+    int cancel;
+    int extend_dir;         // 검색 구간을 넓히는 방향
+    size_t goal;            // 이 위치 너머의 일치를 찾으면 멈춤
+    pthread_cond_t progress;
+} search_state;
 
 typedef struct {
     int lines;          // 터미널 높이
     int cols;           // 터미널 너비
-    int current_line;   // 현재 줄 번호
-    int total_lines;    // 전체 줄 수
-    char **content;     // 파일 내용 저장
     char *filename;     // 현재 파일명
+    
+    // 내용: 일반 파일은 mmap, 표준입력 등은 필요할 때마다 읽어 늘리는 버퍼
+    int fd;
+    char *data;
+    size_t size;        // 지금까지 매핑했거나 읽은 바이트 수
+    size_t capacity;    // 읽기 버퍼 크기 (mmap이 아닐 때)
+    int mapped;
+    int eof;            // 더 읽을 내용이 없는지
+    
+    size_t top;         // 화면 첫 줄의 시작 위치 (바이트)
+    size_t bottom;      // 화면에 보이지 않은 첫 줄의 시작 위치
+    int at_end;         // 마지막 표시에서 내용 끝까지 보였는지
+    
+    // 드문드문 만든 줄 인덱스: checkpoints[k]는 (k * INDEX_STRIDE)번째 줄의 시작 위치
+    // data/size를 바꾸거나 백그라운드 스레드가 data를 읽을 때, 검색 캐시를 다룰 때는 index_lock을 잡음
+    pthread_mutex_t index_lock;
+    size_t *checkpoints;
+    size_t checkpoint_count;
+    size_t checkpoint_capacity;
+    size_t indexed_bytes;   // 이 위치 이전의 개행은 모두 셈
+    long indexed_lines;     // indexed_bytes 이전의 개행 수
+    pthread_t indexer;
+    int indexer_running;    // join할 인덱서 스레드가 있는지
+    int indexing;           // 인덱서 스레드가 아직 훑는 중인지 (index_lock으로 보호)
+    volatile int stop_indexer;
+    int loaded;             // load_file_content 이후 free_content 전인지
+    
+    search_state search;
+    char message[160];      // 다음 상태 줄에 한 번 표시할 메시지
+    char hint[160];         // 다음 상태 줄 끝에 한 번 덧붙일 안내
 } more_state;
 
 // 전역 변수
 static struct termios original_termios;
 static int termios_saved = 0;
+static int tty_fd = STDIN_FILENO;   // 키 입력을 읽는 터미널 (내용이 표준입력이면 /dev/tty)
 
 // 함수 선언
 void setup_terminal(void);
@@ -33,10 +102,12 @@ int load_file_content(const char *filename, more_state *state);
 void display_page(more_state *state);
 void display_status(more_state *state);
 int handle_input(more_state *state);
+int process_key(more_state *state, char ch);
 void free_content(more_state *state);
 void print_usage(void);
 void signal_handler(int sig);
 char get_char(void);
+static int check_shrunk(more_state *state);
 
 // 신호 핸들러
 void signal_handler(int sig) {
@@ -54,9 +125,12 @@ void print_usage(void) {
     printf("  q         Quit\n");
     printf("  h         Show this help\n");
     printf("  b         Go back one page\n");
+    printf("  F         Follow the end of the file\n");
     printf("  f         Go forward one page\n");
     printf("  /pattern  Search for pattern\n");
+    printf("  ?pattern  Search backward for pattern\n");
     printf("  n         Find next occurrence\n");
+    printf("  N         Find previous occurrence\n");
     printf("  g         Go to beginning\n");
     printf("  G         Go to end\n");
 }
@@ -66,7 +140,7 @@ void setup_terminal(void) {
     struct termios new_termios;
     
     // 현재 터미널 설정 저장
-    if (tcgetattr(STDIN_FILENO, &original_termios) == 0) {
+    if (tcgetattr(tty_fd, &original_termios) == 0) {
         termios_saved = 1;
         
         // 새로운 설정 복사
@@ -77,7 +151,7 @@ void setup_terminal(void) {
         new_termios.c_cc[VMIN] = 1;
         new_termios.c_cc[VTIME] = 0;
         
-        tcsetattr(STDIN_FILENO, TCSANOW, &new_termios);
+        tcsetattr(tty_fd, TCSANOW, &new_termios);
     }
     
     // 신호 핸들러 설정
@@ -88,7 +162,7 @@ void setup_terminal(void) {
 // 터미널 복원
 void restore_terminal(void) {
     if (termios_saved) {
-        tcsetattr(STDIN_FILENO, TCSANOW, &original_termios);
+        tcsetattr(tty_fd, TCSANOW, &original_termios);
         termios_saved = 0;
     }
 }
@@ -97,12 +171,13 @@ void restore_terminal(void) {
 void get_terminal_size(int *rows, int *cols) {
     struct winsize ws;
     
+    *rows = DEFAULT_LINES;
+    *cols = DEFAULT_COLS;
+    
+    // 크기를 설정하지 않은 pty나 시리얼 콘솔은 0을 돌려주므로 그때는 기본값 유지
     if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0) {
-        *rows = ws.ws_row;
-        *cols = ws.ws_col;
-    } else {
-        *rows = DEFAULT_LINES;
-        *cols = DEFAULT_COLS;
+        if (ws.ws_row > 0) *rows = ws.ws_row;
+        if (ws.ws_col > 0) *cols = ws.ws_col;
     }
     
     // 상태 표시를 위해 한 줄 빼기
@@ -114,211 +189,1339 @@ void get_terminal_size(int *rows, int *cols) {
 // 문자 하나 읽기 (non-blocking)
 char get_char(void) {
     char ch;
-    if (read(STDIN_FILENO, &ch, 1) == 1) {
+    if (read(tty_fd, &ch, 1) == 1) {
         return ch;
     }
     return 0;
 }
 
-// 파일 내용 로드
-int load_file_content(const char *filename, more_state *state) {
-    FILE *file;
-    char line[MAX_LINE_LENGTH];
-    int capacity = 1000;  // 초기 용량
-    int line_count = 0;
+// 화면 한 줄 (SGR 시퀀스를 포함해 터미널에 보낼 바이트)
+typedef struct {
+    char *text;
+    size_t len;
+    size_t capacity;
+} screen_row;
+
+// 화면 모델: 새 화면(frame)을 메모리에 그린 뒤 지난번에 보낸 화면(shown)과 비교해
+// 달라진 줄만 (줄 단위 스크롤은 스크롤 영역으로) 한 번의 write로 내보냄
+typedef struct {
+    int rows;               // 내용 줄 수 (상태 줄 제외)
+    screen_row *shown;
+    screen_row *frame;
+    int valid;              // shown이 실제 터미널 내용과 같은지
+    int cursor;             // frame에서 지금 그리는 줄
+    char *out;              // 한 화면 분량의 출력
+    size_t out_len;
+    size_t out_capacity;
+} screen_model;
+
+static screen_model screen;
+
+// 화면 모델 준비 (rows는 상태 줄을 뺀 줄 수)
+static int screen_init(int rows) {
+    screen.rows = rows;
+    screen.shown = calloc(rows, sizeof(screen_row));
+    screen.frame = calloc(rows, sizeof(screen_row));
+    screen.valid = 0;
+    screen.cursor = 0;
+    return screen.shown != NULL && screen.frame != NULL ? 0 : -1;
+}
+
+static void screen_free(void) {
+    for (int i = 0; screen.shown && screen.frame && i < screen.rows; i++) {
+        free(screen.shown[i].text);
+        free(screen.frame[i].text);
+    }
+    free(screen.shown);
+    free(screen.frame);
+    free(screen.out);
+    memset(&screen, 0, sizeof(screen));
+}
+
+// 모델 밖에서 터미널에 직접 출력했으면 다음 화면은 전체를 다시 그림
+static void screen_invalidate(void) {
+    screen.valid = 0;
+}
+
+// 새 화면 그리기 시작
+static void screen_begin(void) {
+    for (int i = 0; i < screen.rows; i++) {
+        screen.frame[i].len = 0;
+    }
+    screen.cursor = 0;
+}
+
+static void row_append(screen_row *row, const char *text, size_t len) {
+    if (row->len + len > row->capacity) {
+        size_t capacity = row->capacity ? row->capacity : 128;
+        while (capacity < row->len + len) capacity *= 2;
+        char *grown = realloc(row->text, capacity);
+        if (grown == NULL) {
+            return;
+        }
+        row->text = grown;
+        row->capacity = capacity;
+    }
+    memcpy(row->text + row->len, text, len);
+    row->len += len;
+}
+
+static int row_equal(const screen_row *a, const screen_row *b) {
+    return a->len == b->len && memcmp(a->text, b->text, a->len) == 0;
+}
+
+// 지금 그리는 줄에 내용 덧붙이기 / 다음 줄로
+static void screen_put(const char *text, size_t len) {
+    if (screen.cursor < screen.rows) {
+        row_append(&screen.frame[screen.cursor], text, len);
+    }
+}
+
+static void screen_newline(void) {
+    screen.cursor++;
+}
+
+static void out_append(const char *text, size_t len) {
+    if (screen.out_len + len > screen.out_capacity) {
+        size_t capacity = screen.out_capacity ? screen.out_capacity : 16 * 1024;
+        while (capacity < screen.out_len + len) capacity *= 2;
+        char *grown = realloc(screen.out, capacity);
+        if (grown == NULL) {
+            return;
+        }
+        screen.out = grown;
+        screen.out_capacity = capacity;
+    }
+    memcpy(screen.out + screen.out_len, text, len);
+    screen.out_len += len;
+}
+
+static void out_printf(const char *format, ...) {
+    char buf[64];
+    va_list ap;
+    va_start(ap, format);
+    int len = vsnprintf(buf, sizeof(buf), format, ap);
+    va_end(ap);
+    out_append(buf, len < (int)sizeof(buf) ? len : (int)sizeof(buf) - 1);
+}
+
+// 지난 화면을 얼마나 밀면 새 화면과 맞는 줄이 가장 많은지 (양수: 위로, 음수: 아래로, 0: 밀지 않음)
+// 빈 줄끼리 맞는 것은 세지 않음
+static int screen_find_scroll(void) {
+    int n = screen.rows;
+    int best = 0, best_match = 0;
     
-    // 파일명이 "-"이면 표준 입력
-    if (strcmp(filename, "-") == 0) {
-        file = stdin;
-        state->filename = "stdin";
+    for (int i = 0; i < n; i++) {
+        if (screen.frame[i].len > 0 && row_equal(&screen.frame[i], &screen.shown[i])) {
+            best_match++;
+        }
+    }
+    
+    for (int k = 1; k < n; k++) {
+        // 위로 k줄: frame[i] == shown[i + k], 첫 줄이 맞는 경우만 살펴봄
+        if (screen.frame[0].len > 0 && row_equal(&screen.frame[0], &screen.shown[k])) {
+            int match = 0;
+            for (int i = 0; i + k < n; i++) {
+                if (screen.frame[i].len > 0 && row_equal(&screen.frame[i], &screen.shown[i + k])) {
+                    match++;
+                }
+            }
+            if (match > best_match) {
+                best = k;
+                best_match = match;
+            }
+        }
+        // 아래로 k줄: frame[i + k] == shown[i]
+        if (screen.shown[0].len > 0 && row_equal(&screen.frame[k], &screen.shown[0])) {
+            int match = 0;
+            for (int i = 0; i + k < n; i++) {
+                if (screen.shown[i].len > 0 && row_equal(&screen.frame[i + k], &screen.shown[i])) {
+                    match++;
+                }
+            }
+            if (match > best_match) {
+                best = -k;
+                best_match = match;
+            }
+        }
+    }
+    return best;
+}
+
+// shown을 터미널과 같은 방식으로 k줄 밀고 새로 드러난 줄은 비움
+static void screen_shift_shown(int k) {
+    int n = screen.rows;
+    int count = k > 0 ? k : -k;
+    screen_row *saved = malloc(count * sizeof(screen_row));
+    
+    if (saved == NULL) {
+        screen.valid = 0;
+        return;
+    }
+    if (k > 0) {
+        memcpy(saved, screen.shown, count * sizeof(screen_row));
+        memmove(screen.shown, screen.shown + count, (n - count) * sizeof(screen_row));
+        memcpy(screen.shown + n - count, saved, count * sizeof(screen_row));
+        for (int i = n - count; i < n; i++) screen.shown[i].len = 0;
     } else {
-        file = fopen(filename, "r");
-        if (file == NULL) {
-            fprintf(stderr, "more: %s: %s\n", filename, strerror(errno));
+        memcpy(saved, screen.shown + n - count, count * sizeof(screen_row));
+        memmove(screen.shown + count, screen.shown, (n - count) * sizeof(screen_row));
+        memcpy(screen.shown, saved, count * sizeof(screen_row));
+        for (int i = 0; i < count; i++) screen.shown[i].len = 0;
+    }
+    free(saved);
+}
+
+// 그린 화면과 상태 줄을 터미널에 반영 (커서는 상태 줄 끝에 남음)
+static void screen_present(const char *status, size_t status_len) {
+    screen.out_len = 0;
+    
+    if (screen.valid) {
+        // 줄 단위로 밀린 화면이면 상태 줄을 뺀 스크롤 영역만 밀고 새로 드러난 줄만 그림
+        int shift = screen_find_scroll();
+        if (shift != 0) {
+            out_printf("\033[1;%dr\033[%d%c\033[r", screen.rows,
+                       shift > 0 ? shift : -shift, shift > 0 ? 'S' : 'T');
+            screen_shift_shown(shift);
+        }
+    }
+    if (!screen.valid) {
+        out_append("\033[H\033[2J", 7);
+        for (int i = 0; i < screen.rows; i++) {
+            screen.shown[i].len = 0;
+        }
+    }
+    
+    int cursor_row = -2;    // 커서가 끝에 있는 줄 (모르면 -2)
+    for (int i = 0; i < screen.rows; i++) {
+        if (row_equal(&screen.frame[i], &screen.shown[i])) {
+            continue;
+        }
+        // 바로 윗줄을 쓴 뒤면 줄바꿈만으로 이동 (상태 줄이 아래에 있어 스크롤되지 않음)
+        if (i > 0 && cursor_row == i - 1) {
+            out_append("\r\n", 2);
+        } else {
+            out_printf("\033[%d;1H", i + 1);
+        }
+        // 마지막 칸까지 찬 줄 뒤에서 지우면 마지막 글자가 지워지므로 먼저 지우고 씀
+        if (screen.shown[i].len > 0) {
+            out_append("\033[K", 3);
+        }
+        out_append(screen.frame[i].text, screen.frame[i].len);
+        cursor_row = i;
+    }
+    
+    // 상태 줄은 프롬프트나 진행률이 덮어쓰므로 매번 다시 그림
+    out_printf("\033[%d;1H\033[K\033[7m", screen.rows + 1);
+    out_append(status, status_len);
+    out_append("\033[0m", 4);
+    
+    fflush(stdout);
+    for (size_t done = 0; done < screen.out_len; ) {
+        ssize_t written = write(STDOUT_FILENO, screen.out + done, screen.out_len - done);
+        if (written == -1) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        done += written;
+    }
+    
+    screen_row *swap = screen.shown;
+    screen.shown = screen.frame;
+    screen.frame = swap;
+    screen.valid = 1;
+}
+
+// 매핑하지 않은 입력에서 한 번 읽어 버퍼 뒤에 붙임 (읽은 바이트 수, 끝이면 0, 오류면 -1)
+static ssize_t read_chunk(more_state *state) {
+    if (state->size + READ_CHUNK > state->capacity) {
+        size_t capacity = state->capacity ? state->capacity * 2 : 4 * READ_CHUNK;
+        char *data = realloc(state->data, capacity);
+        if (data == NULL) {
             return -1;
         }
-        state->filename = strdup(filename);
+        pthread_mutex_lock(&state->index_lock);
+        state->data = data;
+        state->capacity = capacity;
+        pthread_mutex_unlock(&state->index_lock);
     }
     
-    // 파일이 디렉토리인지 확인
-    if (file != stdin) {
-        struct stat st;
-        if (fstat(fileno(file), &st) == 0 && S_ISDIR(st.st_mode)) {
-            fprintf(stderr, "more: %s: Is a directory\n", filename);
-            fclose(file);
+    ssize_t nread;
+    do {
+        nread = read(state->fd, state->data + state->size, READ_CHUNK);
+    } while (nread == -1 && errno == EINTR);
+    
+    if (nread > 0) {
+        pthread_mutex_lock(&state->index_lock);
+        state->size += nread;
+        pthread_mutex_unlock(&state->index_lock);
+    }
+    return nread;
+}
+
+// 표준입력 등 매핑하지 않은 입력을 end 위치까지 (또는 끝까지) 읽어 둠
+static void ensure_data(more_state *state, size_t end) {
+    while (!state->eof && state->size < end) {
+        if (read_chunk(state) <= 0) {
+            state->eof = 1;
+        }
+    }
+}
+
+// off에서 시작하는 줄의 끝 (개행 위치, 개행이 없으면 내용 끝)
+static size_t line_end(more_state *state, size_t off) {
+    size_t scanned = off;
+    
+    for (;;) {
+        char *nl = memchr(state->data + scanned, '\n', state->size - scanned);
+        if (nl != NULL) {
+            return nl - state->data;
+        }
+        if (state->eof) {
+            return state->size;
+        }
+        scanned = state->size;
+        ensure_data(state, state->size + READ_CHUNK);
+    }
+}
+
+// 다음 줄의 시작 위치 (마지막 줄이면 내용 끝)
+static size_t next_line(more_state *state, size_t off) {
+    size_t end = line_end(state, off);
+    return end < state->size ? end + 1 : end;
+}
+
+// 앞 줄의 시작 위치 (개행을 뒤로 찾으므로 앞부분 인덱스가 필요 없음)
+static size_t prev_line(more_state *state, size_t off) {
+    if (off <= 1) {
+        return 0;
+    }
+    char *nl = memrchr(state->data, '\n', off - 1);
+    return nl ? (size_t)(nl - state->data) + 1 : 0;
+}
+
+// 인덱스를 지금 위치에서 최대 limit 바이트 더 확장 (개행을 세며 INDEX_STRIDE 줄마다 시작 위치 기록)
+static void index_extend(more_state *state, size_t limit) {
+    pthread_mutex_lock(&state->index_lock);
+    size_t pos = state->indexed_bytes;
+    size_t upto = state->size - pos > limit ? pos + limit : state->size;
+    long lines = state->indexed_lines;
+    
+    while (pos < upto) {
+        char *nl = memchr(state->data + pos, '\n', upto - pos);
+        if (nl == NULL) {
+            break;
+        }
+        pos = nl - state->data + 1;
+        lines++;
+        
+        if (lines % INDEX_STRIDE == 0) {
+            if (state->checkpoint_count == state->checkpoint_capacity) {
+                size_t capacity = state->checkpoint_capacity ? state->checkpoint_capacity * 2 : 256;
+                size_t *checkpoints = realloc(state->checkpoints, capacity * sizeof(size_t));
+                if (checkpoints == NULL) {
+                    break;
+                }
+                state->checkpoints = checkpoints;
+                state->checkpoint_capacity = capacity;
+            }
+            state->checkpoints[state->checkpoint_count++] = pos;
+        }
+    }
+    
+    state->indexed_bytes = upto > pos ? upto : pos;
+    state->indexed_lines = lines;
+    pthread_mutex_unlock(&state->index_lock);
+}
+
+// 백그라운드 인덱서: 매핑된 파일 전체를 큰 조각 단위로 훑음
+// 끝났다는 표시는 잠금 안에서 남기므로, 그 뒤에 파일이 늘면 start_indexer가 새 스레드를 띄움
+static void *index_worker(void *arg) {
+    more_state *state = arg;
+    
+    pthread_mutex_lock(&state->index_lock);
+    while (!state->stop_indexer && state->indexed_bytes < state->size) {
+        pthread_mutex_unlock(&state->index_lock);
+        index_extend(state, INDEX_CHUNK);
+        pthread_mutex_lock(&state->index_lock);
+    }
+    state->indexing = 0;
+    pthread_mutex_unlock(&state->index_lock);
+    return NULL;
+}
+
+// 인덱서 스레드 시작 (이미 훑는 중이면 늘어난 부분까지 그 스레드가 이어서 처리)
+static void start_indexer(more_state *state) {
+    pthread_mutex_lock(&state->index_lock);
+    int busy = state->indexing;
+    pthread_mutex_unlock(&state->index_lock);
+    if (busy) {
+        return;
+    }
+    
+    if (state->indexer_running) {
+        pthread_join(state->indexer, NULL);
+        state->indexer_running = 0;
+    }
+    state->stop_indexer = 0;
+    state->indexing = 1;
+    if (pthread_create(&state->indexer, NULL, index_worker, state) == 0) {
+        state->indexer_running = 1;
+    } else {
+        state->indexing = 0;
+    }
+}
+
+// 인덱서 스레드를 멈추고 기다림
+static void stop_indexer(more_state *state) {
+    if (state->indexer_running) {
+        state->stop_indexer = 1;
+        pthread_join(state->indexer, NULL);
+        state->indexer_running = 0;
+        state->indexing = 0;
+    }
+}
+
+// off에서 시작하는 줄의 줄 번호 (1부터, 아직 인덱스가 닿지 않았으면 -1)
+static long line_number_at(more_state *state, size_t off) {
+    long number = -1;
+    
+    pthread_mutex_lock(&state->index_lock);
+    if (off <= state->indexed_bytes) {
+        // off 이하인 마지막 체크포인트 (이진 탐색)
+        size_t lo = 0, hi = state->checkpoint_count;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (state->checkpoints[mid] <= off) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        size_t pos = lo ? state->checkpoints[lo - 1] : 0;
+        number = (long)lo * INDEX_STRIDE + 1;
+        
+        // 체크포인트부터 최대 INDEX_STRIDE줄만 셈
+        char *nl;
+        while (pos < off && (nl = memchr(state->data + pos, '\n', off - pos)) != NULL) {
+            pos = nl - state->data + 1;
+            number++;
+        }
+    }
+    pthread_mutex_unlock(&state->index_lock);
+    return number;
+}
+
+// [from, to) 구간에서 패턴의 첫 위치 찾기 (찾으면 1, 일치 범위는 *start, *end)
+static int find_match(more_state *state, size_t from, size_t to, size_t *start, size_t *end) {
+    search_state *s = &state->search;
+    
+    if (from >= to) {
+        return 0;
+    }
+    if (s->literal) {
+        char *hit = memmem(state->data + from, to - from, s->pattern, s->pattern_len);
+        if (hit == NULL) {
+            return 0;
+        }
+        *start = hit - state->data;
+        *end = *start + s->pattern_len;
+        return 1;
+    }
+    
+    // regoff_t가 int라서 전체 버퍼 기준 위치 대신 구간 시작 기준으로 넘김
+    // 줄 중간에서 이어 찾을 때는 ^가 다시 맞지 않도록 REG_NOTBOL
+    regmatch_t m;
+    int eflags = REG_STARTEND;
+    if (from > 0 && state->data[from - 1] != '\n') {
+        eflags |= REG_NOTBOL;
+    }
+    m.rm_so = 0;
+    m.rm_eo = to - from;
+    if (regexec(&s->regex, state->data + from, 1, &m, eflags) != 0) {
+        return 0;
+    }
+    *start = from + m.rm_so;
+    *end = from + m.rm_eo;
+    return 1;
+}
+
+// [lo, hi) 구간(줄 경계)에서 패턴이 있는 줄의 시작 위치를 차례로 found에 모음
+static void scan_matches(more_state *state, size_t lo, size_t hi,
+                         size_t **found, size_t *count, size_t *capacity) {
+    size_t pos = lo;
+    size_t start, end;
+    
+    while (pos < hi && find_match(state, pos, hi, &start, &end)) {
+        char *nl = start > lo ? memrchr(state->data + lo, '\n', start - lo) : NULL;
+        size_t line = nl ? (size_t)(nl - state->data) + 1 : lo;
+        
+        if (*count == *capacity) {
+            size_t new_capacity = *capacity ? *capacity * 2 : 256;
+            size_t *grown = realloc(*found, new_capacity * sizeof(size_t));
+            if (grown == NULL) {
+                return;
+            }
+            *found = grown;
+            *capacity = new_capacity;
+        }
+        (*found)[(*count)++] = line;
+        
+        nl = memchr(state->data + start, '\n', hi - start);
+        pos = nl ? (size_t)(nl - state->data) + 1 : hi;
+    }
+}
+
+// 검색 스레드: 검색을 마친 구간을 extend_dir 방향으로 SEARCH_CHUNK씩 넓히며 일치 위치를 캐시에 추가
+// goal 너머(정방향) 또는 goal 이전(역방향)의 일치를 찾으면 그 조각까지만 처리하고 멈춤
+static void *search_worker(void *arg) {
+    more_state *state = arg;
+    search_state *s = &state->search;
+    size_t *found = NULL;
+    size_t found_capacity = 0;
+    
+    pthread_mutex_lock(&state->index_lock);
+    while (!s->cancel) {
+        size_t lo, hi;
+        
+        if (s->extend_dir > 0) {
+            if (s->covered_hi >= state->size) break;
+            lo = s->covered_hi;
+            hi = lo + SEARCH_CHUNK < state->size ? lo + SEARCH_CHUNK : state->size;
+            // 조각 끝을 다음 줄 시작으로 맞춤 (마지막 줄이 미완성이면 내용 끝까지)
+            char *nl = memchr(state->data + hi - 1, '\n', state->size - hi + 1);
+            hi = nl ? (size_t)(nl - state->data) + 1 : state->size;
+        } else {
+            if (s->covered_lo == 0) break;
+            hi = s->covered_lo;
+            lo = hi > SEARCH_CHUNK ? hi - SEARCH_CHUNK : 0;
+            char *nl = lo > 0 ? memrchr(state->data, '\n', lo) : NULL;
+            lo = nl ? (size_t)(nl - state->data) + 1 : 0;
+        }
+        
+        size_t found_count = 0;
+        scan_matches(state, lo, hi, &found, &found_count, &found_capacity);
+        
+        // 캐시는 정렬 상태를 유지 (정방향은 뒤에, 역방향은 앞에 붙임)
+        if (s->match_count + found_count > s->match_capacity) {
+            size_t capacity = s->match_capacity ? s->match_capacity : 256;
+            while (capacity < s->match_count + found_count) capacity *= 2;
+            size_t *grown = realloc(s->matches, capacity * sizeof(size_t));
+            if (grown == NULL) break;
+            s->matches = grown;
+            s->match_capacity = capacity;
+        }
+        if (s->extend_dir > 0) {
+            memcpy(s->matches + s->match_count, found, found_count * sizeof(size_t));
+            s->covered_hi = hi;
+        } else {
+            memmove(s->matches + found_count, s->matches, s->match_count * sizeof(size_t));
+            memcpy(s->matches, found, found_count * sizeof(size_t));
+            s->covered_lo = lo;
+        }
+        s->match_count += found_count;
+        pthread_cond_broadcast(&s->progress);
+        
+        int satisfied = found_count > 0 &&
+            (s->extend_dir > 0 ? found[found_count - 1] > s->goal : found[0] < s->goal);
+        if (satisfied) break;
+        
+        // 조각 사이에서 UI와 인덱서가 잠금을 얻을 수 있게 함
+        pthread_mutex_unlock(&state->index_lock);
+        pthread_mutex_lock(&state->index_lock);
+    }
+    s->running = 0;
+    pthread_cond_broadcast(&s->progress);
+    pthread_mutex_unlock(&state->index_lock);
+    
+    free(found);
+    return NULL;
+}
+
+// 실행 중인 검색 스레드를 멈추고 기다림
+static void stop_search(more_state *state) {
+    search_state *s = &state->search;
+    
+    if (s->joinable) {
+        pthread_mutex_lock(&state->index_lock);
+        s->cancel = 1;
+        pthread_mutex_unlock(&state->index_lock);
+        pthread_join(s->thread, NULL);
+        s->joinable = 0;
+    }
+}
+
+// 일치 위치 캐시 비우기 (검색 구간을 top 위치에서 다시 시작)
+static void reset_search_cache(more_state *state) {
+    search_state *s = &state->search;
+    
+    stop_search(state);
+    s->match_count = 0;
+    s->covered_lo = s->covered_hi = state->top;
+}
+
+// 새 패턴 설정 (정규식 메타 문자가 없으면 memmem 기반 리터럴 검색)
+static int set_pattern(more_state *state, const char *pattern) {
+    search_state *s = &state->search;
+    
+    stop_search(state);
+    if (s->regex_ok) {
+        regfree(&s->regex);
+        s->regex_ok = 0;
+    }
+    free(s->pattern);
+    s->pattern = strdup(pattern);
+    s->pattern_len = strlen(pattern);
+    s->literal = strpbrk(pattern, ".[]()*+?{}|^$\\") == NULL;
+    
+    if (!s->literal) {
+        int err = regcomp(&s->regex, pattern, REG_EXTENDED | REG_NEWLINE);
+        if (err != 0) {
+            char msg[128];
+            regerror(err, &s->regex, msg, sizeof(msg));
+            snprintf(state->message, sizeof(state->message), "Invalid pattern: %s", msg);
+            free(s->pattern);
+            s->pattern = NULL;
             return -1;
         }
+        s->regex_ok = 1;
     }
+    reset_search_cache(state);
+    return 0;
+}
+
+// 캐시에서 top 다음(정방향) 또는 이전(역방향)의 일치 줄 찾기 (잠금을 잡은 상태에서 호출)
+static int cached_match(more_state *state, int dir, size_t *line) {
+    search_state *s = &state->search;
+    size_t lo = 0, hi = s->match_count;
     
-    // 메모리 할당
-    state->content = malloc(capacity * sizeof(char*));
-    if (state->content == NULL) {
-        fprintf(stderr, "more: Memory allocation failed\n");
-        if (file != stdin) fclose(file);
-        return -1;
+    // top보다 큰 첫 일치 위치 (이진 탐색)
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (s->matches[mid] <= state->top) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    // 캐시는 top을 포함하는 연속 구간의 일치를 모두 담고 있으므로 바로 이웃이 답
+    if (dir > 0) {
+        if (lo < s->match_count) {
+            *line = s->matches[lo];
+            return 1;
+        }
+        return 0;
+    }
+    while (lo > 0 && s->matches[lo - 1] >= state->top) lo--;
+    if (lo > 0) {
+        *line = s->matches[lo - 1];
+        return 1;
+    }
+    return 0;
+}
+
+// 키 입력이 있는지 기다리지 않고 확인
+static int key_pending(void) {
+    struct pollfd pfd = { tty_fd, POLLIN, 0 };
+    return poll(&pfd, 1, 0) > 0;
+}
+
+// 검색 실행: 캐시에 답이 없으면 검색 스레드로 구간을 넓히며 진행률 표시, 키를 누르면 취소
+static void run_search(more_state *state, int dir) {
+    search_state *s = &state->search;
+    
+    if (s->pattern == NULL) {
+        snprintf(state->message, sizeof(state->message), "No previous search pattern");
+        return;
     }
     
-    // 파일 내용 읽기
-    while (fgets(line, sizeof(line), file) != NULL) {
-        // 용량 확장 필요시
-        if (line_count >= capacity) {
-            capacity *= 2;
-            char **new_content = realloc(state->content, capacity * sizeof(char*));
-            if (new_content == NULL) {
-                fprintf(stderr, "more: Memory allocation failed\n");
-                free_content(state);
-                if (file != stdin) fclose(file);
-                return -1;
+    // 캐시 구간이 현재 위치를 포함하지 않으면 현재 위치에서 새로 시작
+    if (state->top < s->covered_lo || state->top > s->covered_hi) {
+        reset_search_cache(state);
+    }
+    
+    for (;;) {
+        size_t line;
+        
+        pthread_mutex_lock(&state->index_lock);
+        if (cached_match(state, dir, &line)) {
+            pthread_mutex_unlock(&state->index_lock);
+            state->top = line;
+            return;
+        }
+        
+        int exhausted = dir > 0 ? s->covered_hi >= state->size : s->covered_lo == 0;
+        size_t done = dir > 0 ? s->covered_hi - state->top : state->top - s->covered_lo;
+        size_t total = dir > 0 ? state->size - state->top : state->top;
+        int running = s->running;
+        pthread_mutex_unlock(&state->index_lock);
+        
+        if (exhausted && !running) {
+            if (dir > 0 && !state->eof) {
+                // 아직 읽지 않은 입력이 있으면 더 읽고 계속 검색
+                ensure_data(state, state->size + 16 * READ_CHUNK);
+                continue;
             }
-            state->content = new_content;
+            snprintf(state->message, sizeof(state->message), "Pattern not found");
+            return;
         }
         
-        // 줄 복사 (개행 문자 제거)
-        int len = strlen(line);
-        if (len > 0 && line[len-1] == '\n') {
-            line[len-1] = '\0';
+        if (!running) {
+            if (s->joinable) {
+                pthread_join(s->thread, NULL);
+                s->joinable = 0;
+            }
+            s->extend_dir = dir;
+            s->goal = state->top;
+            s->cancel = 0;
+            s->running = 1;
+            if (pthread_create(&s->thread, NULL, search_worker, state) != 0) {
+                s->running = 0;
+                snprintf(state->message, sizeof(state->message), "Cannot start search");
+                return;
+            }
+            s->joinable = 1;
         }
         
-        state->content[line_count] = strdup(line);
-        if (state->content[line_count] == NULL) {
-            fprintf(stderr, "more: Memory allocation failed\n");
-            free_content(state);
-            if (file != stdin) fclose(file);
+        // 진행률 표시 후 잠시 대기, 그 사이 키가 눌리면 취소
+        printf("\r\033[K\033[7mSearching %s... %d%% (press any key to cancel)\033[0m",
+               s->pattern, total ? (int)(done * 100 / total) : 100);
+        fflush(stdout);
+        
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += 100 * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+        pthread_mutex_lock(&state->index_lock);
+        if (s->running) {
+            pthread_cond_timedwait(&s->progress, &state->index_lock, &deadline);
+        }
+        pthread_mutex_unlock(&state->index_lock);
+        
+        if (key_pending()) {
+            get_char();
+            stop_search(state);
+            snprintf(state->message, sizeof(state->message), "Search cancelled");
+            return;
+        }
+    }
+}
+
+// 상태 줄에 프롬프트를 띄우고 검색어 입력 받기 (ESC나 빈 입력 후 백스페이스로 취소)
+static char *read_pattern(char prompt) {
+    size_t len = 0, capacity = 64;
+    char *buf = malloc(capacity);
+    
+    if (buf == NULL) {
+        return NULL;
+    }
+    printf("\r\033[K%c", prompt);
+    fflush(stdout);
+    
+    for (;;) {
+        char ch = get_char();
+        
+        if (ch == '\n' || ch == '\r') {
+            break;
+        }
+        if (ch == '\033' || ch == 0 || ((ch == 127 || ch == '\b') && len == 0)) {
+            free(buf);
+            return NULL;
+        }
+        if (ch == 127 || ch == '\b') {
+            len--;
+            printf("\b \b");
+        } else {
+            if (len + 1 >= capacity) {
+                capacity *= 2;
+                char *grown = realloc(buf, capacity);
+                if (grown == NULL) break;
+                buf = grown;
+            }
+            buf[len++] = ch;
+            putchar(ch);
+        }
+        fflush(stdout);
+    }
+    buf[len] = '\0';
+    return buf;
+}
+
+// 한 줄 안의 일치 범위들 찾기 (화면 강조용, 최대 max개)
+static int line_matches(more_state *state, size_t off, size_t end,
+                        size_t *starts, size_t *ends, int max) {
+    int count = 0;
+    size_t pos = off;
+    size_t start, stop;
+    
+    if (state->search.pattern == NULL) {
+        return 0;
+    }
+    while (count < max && pos < end && find_match(state, pos, end, &start, &stop)) {
+        if (stop == start) {
+            // 빈 일치는 강조할 것이 없으므로 한 칸 건너뜀
+            pos = start + 1;
+            continue;
+        }
+        starts[count] = start;
+        ends[count] = stop;
+        count++;
+        pos = stop;
+    }
+    return count;
+}
+
+// [from, to) 구간을 출력하면서 일치 범위는 반전 표시
+static void print_highlighted(more_state *state, size_t from, size_t to,
+                              size_t *starts, size_t *ends, int count) {
+    size_t pos = from;
+    
+    for (int i = 0; i < count && pos < to; i++) {
+        if (ends[i] <= pos || starts[i] >= to) {
+            continue;
+        }
+        size_t hl_start = starts[i] > pos ? starts[i] : pos;
+        size_t hl_end = ends[i] < to ? ends[i] : to;
+        screen_put(state->data + pos, hl_start - pos);
+        screen_put("\033[7m", 4);
+        screen_put(state->data + hl_start, hl_end - hl_start);
+        screen_put("\033[0m", 4);
+        pos = hl_end;
+    }
+    screen_put(state->data + pos, to - pos);
+}
+
+// 파일 내용 로드 (일반 파일은 매핑만 하고 줄 인덱스는 백그라운드에서 생성)
+// 매핑한 파일이 잘린 뒤 새 끝을 넘어 읽으면 SIGBUS가 남 (화면 표시, 인덱서, 검색 스레드 어디서든)
+// 핸들러는 그 자리부터 매핑 끝까지를 0으로 채운 익명 페이지로 바꿔 읽기가 그대로 이어지게 하고
+// content_shrunk만 표시함, 실제 복구는 메인 스레드가 check_shrunk -> reset_content로 함
+static more_state *sigbus_state = NULL;
+static volatile sig_atomic_t content_shrunk = 0;
+static uintptr_t sigbus_page_size = 4096;
+
+static void sigbus_handler(int sig, siginfo_t *info, void *context) {
+    (void)context;
+    
+    more_state *state = sigbus_state;
+    char *addr = info->si_addr;
+    
+    if (state && state->mapped && addr >= state->data && addr < state->data + state->size) {
+        char *start = (char *)((uintptr_t)addr & ~(sigbus_page_size - 1));
+        void *zero = mmap(start, state->data + state->size - start, PROT_READ,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+        if (zero != MAP_FAILED) {
+            content_shrunk = 1;
+            return;
+        }
+    }
+    
+    // 매핑한 내용과 관계없는 SIGBUS는 원래대로 종료
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+static void install_sigbus_handler(more_state *state) {
+    static int installed = 0;
+    
+    sigbus_state = state;
+    if (!installed) {
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_sigaction = sigbus_handler;
+        sa.sa_flags = SA_SIGINFO;
+        sigemptyset(&sa.sa_mask);
+        long page = sysconf(_SC_PAGESIZE);
+        if (page > 0) {
+            sigbus_page_size = (uintptr_t)page;
+        }
+        sigaction(SIGBUS, &sa, NULL);
+        installed = 1;
+    }
+}
+
+int load_file_content(const char *filename, more_state *state) {
+    pthread_mutex_init(&state->index_lock, NULL);
+    state->loaded = 1;
+    state->fd = -1;
+    state->data = NULL;
+    state->checkpoints = NULL;
+    state->indexer_running = 0;
+    
+    // 파일명이 "-"이면 표준 입력
+    if (strcmp(filename, "-") == 0) {
+        state->fd = STDIN_FILENO;
+        state->filename = "stdin";
+    } else {
+        state->fd = open(filename, O_RDONLY);
+        if (state->fd == -1) {
+            fprintf(stderr, "more: %s: %s\n", filename, strerror(errno));
             return -1;
         }
-        line_count++;
+        state->filename = strdup(filename);
     }
     
-    if (file != stdin) {
-        fclose(file);
+    state->data = NULL;
+    state->size = 0;
+    state->capacity = 0;
+    state->mapped = 0;
+    state->eof = 0;
+    state->top = 0;
+    state->bottom = 0;
+    state->at_end = 0;
+    state->checkpoints = NULL;
+    state->checkpoint_count = 0;
+    state->checkpoint_capacity = 0;
+    state->indexed_bytes = 0;
+    state->indexed_lines = 0;
+    state->indexer_running = 0;
+    state->indexing = 0;
+    state->stop_indexer = 0;
+    state->search.match_count = 0;
+    state->search.covered_lo = 0;
+    state->search.covered_hi = 0;
+    
+    struct stat st;
+    if (fstat(state->fd, &st) == 0) {
+        // 파일이 디렉토리인지 확인
+        if (S_ISDIR(st.st_mode)) {
+            fprintf(stderr, "more: %s: Is a directory\n", filename);
+            free_content(state);
+            return -1;
+        }
+        
+        if (S_ISREG(st.st_mode) && st.st_size > 0) {
+            void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, state->fd, 0);
+            if (map != MAP_FAILED) {
+                state->data = map;
+                state->size = st.st_size;
+                state->mapped = 1;
+                state->eof = 1;
+                install_sigbus_handler(state);
+            }
+        }
     }
     
-    state->total_lines = line_count;
-    state->current_line = 0;
+    // 매핑한 파일은 첫 화면을 바로 보여주고 인덱스는 따로 만듦
+    if (state->mapped) {
+        start_indexer(state);
+    }
     
     return 0;
 }
 
 // 메모리 해제
 void free_content(more_state *state) {
-    if (state->content != NULL) {
-        for (int i = 0; i < state->total_lines; i++) {
-            if (state->content[i] != NULL) {
-                free(state->content[i]);
-            }
+    if (!state->loaded) {
+        return;
+    }
+    state->loaded = 0;
+    
+    stop_search(state);
+    stop_indexer(state);
+    
+    if (state->data != NULL) {
+        if (state->mapped) {
+            munmap(state->data, state->size);
+        } else {
+            free(state->data);
         }
-        free(state->content);
-        state->content = NULL;
+        state->data = NULL;
+    }
+    free(state->checkpoints);
+    state->checkpoints = NULL;
+    pthread_mutex_destroy(&state->index_lock);
+    
+    if (state->fd > STDIN_FILENO) {
+        close(state->fd);
     }
+    state->fd = -1;
     
     if (state->filename != NULL && strcmp(state->filename, "stdin") != 0) {
         free(state->filename);
-        state->filename = NULL;
     }
+    state->filename = NULL;
 }
 
-// 페이지 표시
-void display_page(more_state *state) {
-    // 화면 지우기
-    printf("\033[2J\033[H");
+// off에서 시작하는 줄을 터미널 너비에 맞춰 잘라 출력하고 다음 줄 시작 위치를 돌려줌
+// (*rows는 출력한 화면 줄 수, 화면이 차면 줄 중간에서 멈춤)
+static size_t render_line(more_state *state, size_t off, int *rows) {
+    size_t end = line_end(state, off);
+    size_t len = end - off;
+    size_t pos = 0;
+    size_t hl_starts[MAX_HIGHLIGHTS], hl_ends[MAX_HIGHLIGHTS];
+    int hl_count = line_matches(state, off, end, hl_starts, hl_ends, MAX_HIGHLIGHTS);
     
-    // 현재 페이지의 줄들 출력
-    int lines_displayed = 0;
-    int line = state->current_line;
+    do {
+        size_t chars_to_print = (len - pos > (size_t)state->cols) ? (size_t)state->cols : (len - pos);
+        print_highlighted(state, off + pos, off + pos + chars_to_print,
+                          hl_starts, hl_ends, hl_count);
+        screen_newline();
+        (*rows)++;
+        pos += chars_to_print;
+    } while (pos < len && *rows < state->lines);
     
-    while (line < state->total_lines && lines_displayed < state->lines) {
-        // 긴 줄 처리 (터미널 너비에 맞춰 잘라서 표시)
-        char *content = state->content[line];
-        int len = strlen(content);
-        int pos = 0;
+    return end < state->size ? end + 1 : end;
+}
+
+// 페이지 표시 (화면 모델에 그리기만 하고 터미널에는 display_status가 한꺼번에 내보냄)
+void display_page(more_state *state) {
+    size_t off;
+    
+    // 매핑한 파일이 줄었으면 처음부터 다시 읽고 그림 (그리는 도중 SIGBUS로 알게 되면 다시 그림)
+    do {
+        check_shrunk(state);
+        screen_begin();
         
-        while (pos < len && lines_displayed < state->lines) {
-            int chars_to_print = (len - pos > state->cols) ? state->cols : (len - pos);
-            printf("%.*s", chars_to_print, content + pos);
-            
-            if (chars_to_print == state->cols && pos + chars_to_print < len) {
-                // 줄이 잘렸으면 다음 줄로
-                printf("\n");
-                lines_displayed++;
-            } else {
-                printf("\n");
-                lines_displayed++;
-                break;
-            }
-            pos += chars_to_print;
+        // 현재 페이지의 줄들 출력
+        int lines_displayed = 0;
+        off = state->top;
+        
+        ensure_data(state, off + 1);
+        while (off < state->size && lines_displayed < state->lines) {
+            off = render_line(state, off, &lines_displayed);
+            ensure_data(state, off + 1);
         }
-        line++;
-    }
+    } while (content_shrunk);
+    
+    state->bottom = off;
+    state->at_end = off >= state->size && state->eof;
     
-    // 남은 공간 채우기
-    while (lines_displayed < state->lines) {
-        printf("\n");
-        lines_displayed++;
+    // 읽어 둔 입력은 화면 표시 때마다 이어서 인덱스에 반영 (매핑한 파일은 인덱서 스레드 담당)
+    if (!state->mapped) {
+        index_extend(state, (size_t)-1);
     }
 }
 
-// 상태 표시
+// 상태 표시 후 화면 반영 (줄이 넘쳐 화면이 밀리지 않도록 터미널 너비에서 자름)
 void display_status(more_state *state) {
-    int percent = (state->total_lines == 0) ? 100 : 
-                  (state->current_line * 100) / state->total_lines;
+    int percent = (state->size == 0) ? 100 : 
+                  (int)((state->bottom * 100) / state->size);
+    char status[512];
+    int len = 0;
     
-    printf("\033[7m"); // 역상 표시
-    if (state->current_line + state->lines >= state->total_lines) {
-        printf("--More-- (END) ");
+    if (state->message[0]) {
+        len += snprintf(status + len, sizeof(status) - len, "%s ", state->message);
+        state->message[0] = '\0';
+    }
+    if (state->at_end) {
+        len += snprintf(status + len, sizeof(status) - len, "--More-- (END) ");
+    } else if (state->eof) {
+        len += snprintf(status + len, sizeof(status) - len, "--More-- (%d%%) ", percent);
     } else {
-        printf("--More-- (%d%%) ", percent);
+        len += snprintf(status + len, sizeof(status) - len, "--More-- ");
     }
     
-    if (state->filename && strcmp(state->filename, "stdin") != 0) {
-        printf("%s", state->filename);
+    // 인덱스가 닿은 범위면 줄 번호도 표시
+    long first = line_number_at(state, state->top);
+    if (first > 0 && len < (int)sizeof(status)) {
+        long last = line_number_at(state, state->bottom) - 1;
+        len += snprintf(status + len, sizeof(status) - len, "lines %ld-%ld ",
+                        first, last >= first ? last : first);
     }
     
-    printf("\033[0m"); // 정상 표시로 복원
-    fflush(stdout);
+    if (state->filename && strcmp(state->filename, "stdin") != 0 && len < (int)sizeof(status)) {
+        len += snprintf(status + len, sizeof(status) - len, "%s", state->filename);
+    }
+    
+    if (state->hint[0] && len < (int)sizeof(status)) {
+        len += snprintf(status + len, sizeof(status) - len, "%s", state->hint);
+        state->hint[0] = '\0';
+    }
+    
+    if (len > (int)sizeof(status) - 1) {
+        len = sizeof(status) - 1;
+    }
+    if (len > state->cols - 1) {
+        len = state->cols - 1;
+    }
+    if (len < 0) {
+        len = 0;
+    }
+    screen_present(status, len);
+}
+
+// end 위치에서 끝나는 마지막 페이지의 첫 줄 (끝에서부터 거꾸로 한 화면만큼 개행을 찾음)
+static size_t page_ending_at(more_state *state, size_t end) {
+    size_t top = end;
+    for (int i = 0; i < state->lines && top > 0; i++) {
+        top = prev_line(state, top);
+    }
+    return top;
+}
+
+// 파일이 잘렸을 때 인덱스와 검색 캐시를 버리고 처음부터 다시 읽음
+static void reset_content(more_state *state, size_t new_size) {
+    stop_search(state);
+    stop_indexer(state);
+    
+    pthread_mutex_lock(&state->index_lock);
+    if (state->mapped) {
+        munmap(state->data, state->size);
+        void *map = new_size > 0 ? mmap(NULL, new_size, PROT_READ, MAP_PRIVATE, state->fd, 0)
+                                 : MAP_FAILED;
+        if (map != MAP_FAILED) {
+            state->data = map;
+            state->size = new_size;
+        } else {
+            // 빈 파일은 매핑할 수 없으므로 다시 늘어날 때까지 읽기 버퍼로 처리
+            state->data = NULL;
+            state->size = 0;
+            state->capacity = 0;
+            state->mapped = 0;
+        }
+    } else {
+        state->size = 0;
+    }
+    // SIGBUS로 채운 0 페이지는 위에서 매핑과 함께 없어짐
+    content_shrunk = 0;
+    if (!state->mapped) {
+        lseek(state->fd, 0, SEEK_SET);
+    }
+    state->checkpoint_count = 0;
+    state->indexed_bytes = 0;
+    state->indexed_lines = 0;
+    state->search.match_count = 0;
+    state->search.covered_lo = state->search.covered_hi = 0;
+    state->top = state->bottom = 0;
+    pthread_mutex_unlock(&state->index_lock);
+    
+    if (state->mapped) {
+        start_indexer(state);
+    }
+}
+
+// 매핑한 파일이 줄었으면 (fstat 크기가 작거나 SIGBUS가 났으면) 처음부터 다시 읽음
+// 잘린 뒤의 내용을 매핑 너머로 읽기 전에 알아채도록 화면을 그릴 때마다 확인함
+static int check_shrunk(more_state *state) {
+    struct stat st;
+    
+    if (!state->mapped || fstat(state->fd, &st) != 0) {
+        return 0;
+    }
+    if (!content_shrunk && (size_t)st.st_size >= state->size) {
+        return 0;
+    }
+    reset_content(state, st.st_size);
+    snprintf(state->message, sizeof(state->message), "File truncated");
+    return 1;
+}
+
+// 미완성이던 마지막 줄은 이어 붙은 내용과 함께 다시 검색하도록 검색 캐시 구간에서 뺌
+static void trim_search_cache(more_state *state, size_t old_size) {
+    search_state *s = &state->search;
+    
+    if (old_size == 0 || state->data[old_size - 1] == '\n' || s->covered_hi < old_size) {
+        return;
+    }
+    stop_search(state);
+    
+    size_t line = prev_line(state, old_size);
+    pthread_mutex_lock(&state->index_lock);
+    s->covered_hi = line;
+    if (s->covered_lo > line) {
+        s->covered_lo = line;
+    }
+    while (s->match_count > 0 && s->matches[s->match_count - 1] >= line) {
+        s->match_count--;
+    }
+    pthread_mutex_unlock(&state->index_lock);
+}
+
+// 따라가기 중 내용이 바뀌었는지 확인 (1: 늘어남, -1: 잘려서 처음부터 다시 읽음, 0: 그대로)
+// 매핑한 파일은 늘어난 만큼 다시 매핑하고 인덱스는 이어서 만듦
+static int refresh_content(more_state *state) {
+    struct stat st;
+    int regular = fstat(state->fd, &st) == 0 && S_ISREG(st.st_mode);
+    int truncated = regular && (size_t)st.st_size < state->size;
+    size_t old_size = state->size;
+    
+    if (truncated) {
+        reset_content(state, st.st_size);
+        old_size = 0;
+    }
+    
+    if (state->mapped) {
+        if ((size_t)st.st_size <= state->size) {
+            return truncated ? -1 : 0;
+        }
+        pthread_mutex_lock(&state->index_lock);
+        void *map = mremap(state->data, state->size, st.st_size, MREMAP_MAYMOVE);
+        if (map != MAP_FAILED) {
+            state->data = map;
+            state->size = st.st_size;
+        }
+        pthread_mutex_unlock(&state->index_lock);
+        if (map == MAP_FAILED) {
+            return truncated ? -1 : 0;
+        }
+        
+        // 조금 붙은 정도면 바로 인덱스에 반영해 상태 줄의 줄 번호가 늦지 않게 함
+        pthread_mutex_lock(&state->index_lock);
+        int small = !state->indexing && state->size - state->indexed_bytes <= INDEX_CHUNK;
+        pthread_mutex_unlock(&state->index_lock);
+        if (small) {
+            index_extend(state, INDEX_CHUNK);
+        } else {
+            start_indexer(state);
+        }
+    } else {
+        // 매핑하지 않은 입력은 기다리지 않고 지금 읽을 수 있는 만큼만 읽음
+        struct pollfd pfd = { state->fd, POLLIN, 0 };
+        while (poll(&pfd, 1, 0) > 0 && read_chunk(state) > 0) {
+        }
+        state->eof = 1;
+        index_extend(state, (size_t)-1);
+    }
+    
+    if (truncated) {
+        return -1;
+    }
+    if (state->size == old_size) {
+        return 0;
+    }
+    trim_search_cache(state, old_size);
+    return 1;
+}
+
+// F: 파일 끝을 따라가며 새로 붙는 내용을 계속 보여줌 (아무 키나 누르면 멈춤)
+// 일반 파일은 inotify로 변경을 기다리고, 쓸 수 없으면 FOLLOW_POLL_MS 간격으로 확인
+static void follow_mode(more_state *state) {
+    struct stat st;
+    int regular = fstat(state->fd, &st) == 0 && S_ISREG(st.st_mode);
+    int watch = -1;
+    
+    if (regular) {
+        // 표준입력으로 받은 파일도 감시할 수 있게 /proc의 fd 링크로 등록
+        char path[64];
+        snprintf(path, sizeof(path), "/proc/self/fd/%d", state->fd);
+        watch = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (watch != -1 && inotify_add_watch(watch, path, IN_MODIFY) == -1) {
+            close(watch);
+            watch = -1;
+        }
+    }
+    
+    refresh_content(state);
+    state->top = page_ending_at(state, state->size);
+    display_page(state);
+    
+    // 파이프는 읽을 내용이 생기면 바로 깨어나도록 함께 기다림 (쓰는 쪽이 닫히면 뺌)
+    struct pollfd pfds[2] = {
+        { tty_fd, POLLIN, 0 },
+        { watch != -1 ? watch : (regular ? -1 : state->fd), POLLIN, 0 },
+    };
+    
+    for (;;) {
+        snprintf(state->message, sizeof(state->message),
+                 "Waiting for data... (press any key to stop)");
+        display_status(state);
+        
+        int ready = poll(pfds, 2, watch != -1 ? -1 : FOLLOW_POLL_MS);
+        if (ready == -1 && errno != EINTR) {
+            break;
+        }
+        if (pfds[0].revents) {
+            get_char();
+            break;
+        }
+        if (watch != -1 && (pfds[1].revents & POLLIN)) {
+            char events[4096];
+            while (read(watch, events, sizeof(events)) > 0) {
+            }
+        }
+        
+        int changed = refresh_content(state);
+        if (changed == 0) {
+            if (watch == -1 && (pfds[1].revents & POLLHUP)) {
+                pfds[1].fd = -1;
+            }
+            continue;
+        }
+        // 마지막 페이지를 다시 그리면 화면 모델이 밀린 줄 수만큼 스크롤하고 새 줄만 출력함
+        state->top = page_ending_at(state, state->size);
+        display_page(state);
+    }
+    
+    if (watch != -1) {
+        close(watch);
+    }
+    // 파이프가 아직 열려 있으면 평소처럼 이어서 읽을 수 있게 함
+    if (!regular && pfds[1].fd != -1) {
+        state->eof = 0;
+    }
 }
 
 // 입력 처리
 int handle_input(more_state *state) {
     char ch;
-    static char search_pattern[256] = "";
     
     display_status(state);
     ch = get_char();
     
-    // 상태 줄 지우기
-    printf("\r\033[K");
-    
+    return process_key(state, ch);
+}
+
+// 키 하나 처리 (1이면 종료)
+int process_key(more_state *state, char ch) {
     switch (ch) {
         case ' ':  // 다음 페이지
         case 'f':
-            if (state->current_line + state->lines < state->total_lines) {
-                state->current_line += state->lines;
+            if (!state->at_end) {
+                state->top = state->bottom;
             }
             break;
             
         case '\n':  // 다음 줄
         case '\r':
-            if (state->current_line < state->total_lines - 1) {
-                state->current_line++;
+            if (!state->at_end) {
+                state->top = next_line(state, state->top);
             }
             break;
             
         case 'b':  // 이전 페이지
-            state->current_line -= state->lines;
-            if (state->current_line < 0) {
-                state->current_line = 0;
+            for (int i = 0; i < state->lines && state->top > 0; i++) {
+                state->top = prev_line(state, state->top);
             }
             break;
             
         case 'g':  // 처음으로
-            state->current_line = 0;
+            state->top = 0;
+            break;
+            
+        case 'G':  // 끝으로 (끝에서부터 거꾸로 한 화면만큼 개행을 찾음)
+            ensure_data(state, (size_t)-1);
+            state->top = page_ending_at(state, state->size);
+            break;
+            
+        case 'F':  // 파일 끝 따라가기
+            follow_mode(state);
             break;
             
-        case 'G':  // 끝으로
-            state->current_line = state->total_lines - state->lines;
-            if (state->current_line < 0) {
-                state->current_line = 0;
+        case '/':  // 정방향 검색
+        case '?':  // 역방향 검색
+        {
+            char *pattern = read_pattern(ch);
+            if (pattern == NULL) {
+                break;
+            }
+            // 빈 입력이면 이전 패턴을 다시 사용
+            if (pattern[0] == '\0' || set_pattern(state, pattern) == 0) {
+                state->search.direction = ch == '/' ? 1 : -1;
+                run_search(state, state->search.direction);
             }
+            free(pattern);
+            break;
+        }
+            
+        case 'n':  // 같은 방향으로 다음 일치
+            run_search(state, state->search.direction ? state->search.direction : 1);
+            break;
+            
+        case 'N':  // 반대 방향으로 다음 일치
+            run_search(state, state->search.direction ? -state->search.direction : -1);
             break;
             
         case 'h':  // 도움말
@@ -329,10 +1532,16 @@ int handle_input(more_state *state) {
             printf("  b         - Previous page\n");
             printf("  g         - Go to beginning\n");
             printf("  G         - Go to end\n");
+            printf("  F         - Follow appended data (any key stops)\n");
+            printf("  /pattern  - Search forward\n");
+            printf("  ?pattern  - Search backward\n");
+            printf("  n, N      - Repeat search (same/opposite direction)\n");
             printf("  q         - Quit\n");
             printf("  h         - This help\n");
             printf("\nPress any key to continue...");
+            fflush(stdout);
             get_char();
+            screen_invalidate();
             break;
             
         case 'q':  // 종료
@@ -353,6 +1562,8 @@ int main(int argc, char *argv[]) {
     more_state state = {0};
     int result = 0;
     
+    pthread_cond_init(&state.search.progress, NULL);
+    
     // 도움말 출력
     if (argc > 1 && (strcmp(argv[1], "--help") == 0 || strcmp(argv[1], "-h") == 0)) {
         print_usage();
@@ -361,6 +1572,18 @@ int main(int argc, char *argv[]) {
     
     // 터미널 크기 얻기
     get_terminal_size(&state.lines, &state.cols);
+    if (screen_init(state.lines) != 0) {
+        fprintf(stderr, "more: out of memory\n");
+        return 1;
+    }
+    
+    // 내용을 표준입력으로 받으면 키 입력은 터미널에서 직접 읽음
+    if (!isatty(STDIN_FILENO)) {
+        int fd = open("/dev/tty", O_RDONLY);
+        if (fd != -1) {
+            tty_fd = fd;
+        }
+    }
     
     // 터미널 설정
     setup_terminal();
@@ -373,11 +1596,11 @@ int main(int argc, char *argv[]) {
                 display_page(&state);
                 
                 // 파일 끝에 도달했으면 종료
-                if (state.current_line + state.lines >= state.total_lines) {
+                if (state.at_end) {
+                    snprintf(state.hint, sizeof(state.hint), " (END - Press q to quit)");
                     display_status(&state);
-                    printf(" (END - Press q to quit)");
-                    if (get_char() == 'q') break;
-                    printf("\r\033[K");
+                    char ch = get_char();
+                    if (process_key(&state, ch)) break;
                     continue;
                 }
                 
@@ -398,6 +1621,7 @@ int main(int argc, char *argv[]) {
                     printf("\n::::::::::::::\n");
                     printf("%s\n", argv[i]);
                     printf("::::::::::::::\n");
+                    screen_invalidate();
                 }
                 
                 // 메인 루프
@@ -405,23 +1629,27 @@ int main(int argc, char *argv[]) {
                     display_page(&state);
                     
                     // 파일 끝에 도달했으면 다음 파일로
-                    if (state.current_line + state.lines >= state.total_lines) {
+                    if (state.at_end) {
                         if (i < argc - 1) {
+                            snprintf(state.hint, sizeof(state.hint),
+                                     " (Next file: %s - Press SPACE or q to quit)",
+                                     i + 1 < argc ? argv[i + 1] : "");
                             display_status(&state);
-                            printf(" (Next file: %s - Press SPACE or q to quit)", 
-                                   i + 1 < argc ? argv[i + 1] : "");
                             char ch = get_char();
-                            printf("\r\033[K");
                             if (ch == 'q') {
                                 i = argc;  // 모든 파일 처리 중단
                                 break;
                             }
                             break;  // 다음 파일로
                         } else {
+                            // 마지막 파일에서는 q로 끝낼 때까지 계속 이동 가능
+                            snprintf(state.hint, sizeof(state.hint), " (END - Press q to quit)");
                             display_status(&state);
-                            printf(" (END - Press q to quit)");
-                            get_char();
-                            break;
+                            char ch = get_char();
+                            if (process_key(&state, ch)) {
+                                break;
+                            }
+                            continue;
                         }
                     }
                     
@@ -439,6 +1667,7 @@ int main(int argc, char *argv[]) {
     
     // 터미널 복원
     restore_terminal();
+    screen_free();
     
     // 화면 지우기
     printf("\033[2J\033[H");
@@ -447,7 +1676,7 @@ int main(int argc, char *argv[]) {
 }
 
 // 컴파일 방법:
-// gcc -o more more.c
+// gcc -o more more_less.c -pthread
 //
 // 사용 예시:
 // ./more file.txt                   # 파일을 페이지 단위로 보기
@@ -0,0 +1,286 @@
+// /proc 파싱 공용 모듈 (top.c, ps.c, kill.c에서 사용)
+// 프로세스마다 fopen/fscanf를 하지 않고 재사용 버퍼에 pread로 읽은 뒤 직접 파싱함
+// 갱신을 반복하는 top은 프로세스별 stat fd를 열어 두고 재사용함 (cached_fd)
+// 모든 함수가 static이라 각 프로그램은 지금처럼 파일 하나로 컴파일됨 (gcc -o top top.c)
+#ifndef PROCFS_H
+#define PROCFS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <pwd.h>
+#include <sys/resource.h>
+
+#define PROCFS_FD_RESERVE 64        // fd를 열어 두더라도 다른 용도로 남겨 둘 개수
+#define PROCFS_USER_CACHE 64        // uid -> 사용자 이름 캐시 크기
+
+// /proc/PID/stat에서 읽은 값
+typedef struct {
+    int pid;
+    char comm[64];                  // 괄호를 뺀 명령어 이름 (공백이나 괄호가 들어 있을 수 있음)
+    char state;
+    int ppid;
+    int pgrp;
+    int session;
+    int tty_nr;
+    unsigned long utime;            // clock tick
+    unsigned long stime;
+    unsigned long long starttime;   // 부팅 후 시작 시각 (clock tick)
+    unsigned long vsize;            // 바이트
+    long rss;                       // 페이지 수
+} ProcStat;
+
+// /proc/meminfo에서 읽은 값 (kB)
+typedef struct {
+    long total;
+    long free;
+    long available;
+    long buffers;
+    long cached;
+} ProcMeminfo;
+
+// 읽기 버퍼 (한 번 늘리면 계속 재사용)
+static char *procfs_buf = NULL;
+static size_t procfs_buf_size = 0;
+
+// 열어 둔 fd 수와 한도 (RLIMIT_NOFILE soft 한도에서 PROCFS_FD_RESERVE를 뺀 값)
+static long procfs_open_fds = 0;
+static long procfs_fd_limit = -1;
+
+static int procfs_meminfo_fd = -1;
+
+// 열어 둘 수 있는 fd 수 (지금의 soft 한도 안에서만 씀)
+static long procfs_max_open_fds(void) {
+    if (procfs_fd_limit < 0) {
+        struct rlimit rl;
+        procfs_fd_limit = 0;
+        if (getrlimit(RLIMIT_NOFILE, &rl) == 0) {
+            if (rl.rlim_cur == RLIM_INFINITY) {
+                procfs_fd_limit = 1L << 20;
+            } else if (rl.rlim_cur > PROCFS_FD_RESERVE) {
+                procfs_fd_limit = (long)(rl.rlim_cur - PROCFS_FD_RESERVE);
+            }
+        }
+    }
+    return procfs_fd_limit;
+}
+
+// 열어 둔 fd 닫기
+static void procfs_close(int *fd) {
+    if (*fd >= 0) {
+        close(*fd);
+        *fd = -1;
+        procfs_open_fds--;
+    }
+}
+
+// fd 전체를 처음부터 procfs_buf로 읽음 (버퍼가 모자라면 늘려서 다시 읽음, 길이 반환)
+static ssize_t procfs_pread(int fd) {
+    for (;;) {
+        if (procfs_buf_size == 0) {
+            procfs_buf_size = 4096;
+            procfs_buf = malloc(procfs_buf_size);
+            if (!procfs_buf) {
+                procfs_buf_size = 0;
+                return -1;
+            }
+        }
+    
+        ssize_t n = pread(fd, procfs_buf, procfs_buf_size - 1, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if ((size_t)n < procfs_buf_size - 1) {
+            procfs_buf[n] = '\0';
+            return n;
+        }
+    
+        char *grown = realloc(procfs_buf, procfs_buf_size * 2);
+        if (!grown) return -1;
+        procfs_buf = grown;
+        procfs_buf_size *= 2;
+    }
+}
+
+// path를 procfs_buf로 읽음
+// cached_fd가 있으면 그 fd를 재사용하고 (실패하면 다시 열어 봄), 한도 안이면 새로 연 fd도 열어 둠
+static ssize_t procfs_read_file(const char *path, int *cached_fd) {
+    if (cached_fd && *cached_fd >= 0) {
+        ssize_t n = procfs_pread(*cached_fd);
+        if (n > 0) return n;
+        // 프로세스가 끝났거나 pid가 재사용되었으면 경로로 다시 열어 봄
+        procfs_close(cached_fd);
+    }
+    
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    
+    ssize_t n = procfs_pread(fd);
+    if (n >= 0 && cached_fd && procfs_open_fds < procfs_max_open_fds()) {
+        *cached_fd = fd;
+        procfs_open_fds++;
+    } else {
+        close(fd);
+    }
+    return n;
+}
+
+// *p에서 부호 있는 10진수 하나를 읽고 뒤따르는 공백 하나를 건너뜀
+static long long procfs_parse_num(const char **p) {
+    const char *s = *p;
+    int negative = 0;
+    unsigned long long value = 0;
+    
+    if (*s == '-') {
+        negative = 1;
+        s++;
+    }
+    while (*s >= '0' && *s <= '9') {
+        value = value * 10 + (*s - '0');
+        s++;
+    }
+    if (*s == ' ') s++;
+    *p = s;
+    return negative ? -(long long)value : (long long)value;
+}
+
+// /proc/PID/stat 한 줄 파싱
+// comm에는 공백이나 ')'가 들어 있을 수 있으므로 마지막 ')'를 기준으로 나눔
+static int procfs_parse_stat(const char *buf, ProcStat *st) {
+    const char *open_paren = strchr(buf, '(');
+    const char *close_paren = strrchr(buf, ')');
+    
+    if (!open_paren || !close_paren || close_paren < open_paren || close_paren[1] != ' ') {
+        return -1;
+    }
+    
+    st->pid = atoi(buf);
+    size_t len = close_paren - open_paren - 1;
+    if (len >= sizeof(st->comm)) len = sizeof(st->comm) - 1;
+    memcpy(st->comm, open_paren + 1, len);
+    st->comm[len] = '\0';
+    
+    const char *p = close_paren + 2;
+    st->state = *p;
+    if (p[0] == '\0' || p[1] != ' ') return -1;
+    p += 2;
+    
+    // 4번 필드(ppid)부터 24번 필드(rss)까지 차례로 읽음
+    long long field[25];
+    for (int i = 4; i <= 24; i++) {
+        if (*p == '\0') return -1;
+        field[i] = procfs_parse_num(&p);
+    }
+    
+    st->ppid = (int)field[4];
+    st->pgrp = (int)field[5];
+    st->session = (int)field[6];
+    st->tty_nr = (int)field[7];
+    st->utime = (unsigned long)field[14];
+    st->stime = (unsigned long)field[15];
+    st->starttime = (unsigned long long)field[22];
+    st->vsize = (unsigned long)field[23];
+    st->rss = (long)field[24];
+    return 0;
+}
+
+// /proc/PID/stat 읽기 (fd를 열어 두려면 cached_fd를 넘김, 아니면 NULL)
+static int procfs_read_stat(int pid, int *cached_fd, ProcStat *st) {
+    char path[64];
+    
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    if (procfs_read_file(path, cached_fd) <= 0) return -1;
+    return procfs_parse_stat(procfs_buf, st);
+}
+
+// /proc/PID/status의 실제 uid 읽기
+static int procfs_read_uid(int pid, uid_t *uid) {
+    char path[64];
+    
+    snprintf(path, sizeof(path), "/proc/%d/status", pid);
+    if (procfs_read_file(path, NULL) <= 0) return -1;
+    
+    const char *line = strstr(procfs_buf, "\nUid:");
+    if (!line) return -1;
+    const char *p = line + 5;
+    while (*p == ' ' || *p == '\t') p++;
+    if (*p < '0' || *p > '9') return -1;
+    *uid = (uid_t)procfs_parse_num(&p);
+    return 0;
+}
+
+// meminfo에서 "name:" 줄의 값 찾기 (없으면 0)
+static long procfs_meminfo_value(const char *buf, const char *name) {
+    size_t name_len = strlen(name);
+    const char *p = buf;
+    
+    while (p && *p) {
+        if (strncmp(p, name, name_len) == 0 && p[name_len] == ':') {
+            p += name_len + 1;
+            while (*p == ' ') p++;
+            return (long)procfs_parse_num(&p);
+        }
+        p = strchr(p, '\n');
+        if (p) p++;
+    }
+    return 0;
+}
+
+// /proc/meminfo 읽기 (갱신 주기마다 한 번만 부르고, fd는 열어 둔 채 재사용)
+static int procfs_read_meminfo(ProcMeminfo *mi) {
+    if (procfs_read_file("/proc/meminfo", &procfs_meminfo_fd) <= 0) return -1;
+    
+    mi->total = procfs_meminfo_value(procfs_buf, "MemTotal");
+    mi->free = procfs_meminfo_value(procfs_buf, "MemFree");
+    mi->available = procfs_meminfo_value(procfs_buf, "MemAvailable");
+    mi->buffers = procfs_meminfo_value(procfs_buf, "Buffers");
+    mi->cached = procfs_meminfo_value(procfs_buf, "Cached");
+    return 0;
+}
+
+// 페이지 크기 (kB)
+static long procfs_page_kb(void) {
+    static long page_kb = 0;
+    
+    if (page_kb == 0) {
+        long size = sysconf(_SC_PAGESIZE);
+        page_kb = size > 0 ? size / 1024 : 4;
+    }
+    return page_kb;
+}
+
+// uid를 사용자 이름으로 (최근에 찾은 uid는 캐시에서 바로 돌려줌)
+static void procfs_user_name(uid_t uid, char *name, size_t size) {
+    static struct {
+        uid_t uid;
+        char name[32];
+    } cache[PROCFS_USER_CACHE];
+    static int cache_count = 0;
+    static int cache_next = 0;
+    
+    for (int i = 0; i < cache_count; i++) {
+        if (cache[i].uid == uid) {
+            snprintf(name, size, "%s", cache[i].name);
+            return;
+        }
+    }
+    
+    struct passwd *pw = getpwuid(uid);
+    int slot = cache_next;
+    cache_next = (cache_next + 1) % PROCFS_USER_CACHE;
+    if (cache_count < PROCFS_USER_CACHE) cache_count++;
+    
+    cache[slot].uid = uid;
+    if (pw) {
+        snprintf(cache[slot].name, sizeof(cache[slot].name), "%s", pw->pw_name);
+    } else {
+        snprintf(cache[slot].name, sizeof(cache[slot].name), "%u", (unsigned)uid);
+    }
+    snprintf(name, size, "%s", cache[slot].name);
+}
+
+#endif
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include <pwd.h>
 #include <time.h>
 
+#include "procfs.h"
+
 #define MAX_CMD_LEN 256
 #define MAX_PATH_LEN 512
 
@@ -36,90 +38,39 @@ int is_number(const char *str) {
 
 // /proc/pid/stat 파일에서 프로세스 정보 읽기
 int read_proc_stat(int pid, ProcessInfo *proc) {
-    char path[MAX_PATH_LEN];
-    FILE *file;
-    char comm[256];
-    char state;
-    int ppid, pgrp, session, tty_nr;
-    unsigned long utime, stime, vsize;
-    long rss;
-    
-    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
-    file = fopen(path, "r");
-    if (!file) return -1;
-    
-    // stat 파일의 주요 필드들 읽기
-    fscanf(file, "%d %s %c %d %d %d %d %*d %*u %*u %*u %*u %*u %lu %lu %*d %*d %*d %*d %*d %*d %*u %lu %ld",
-           &proc->pid, comm, &state, &ppid, &pgrp, &session, &tty_nr,
-           &utime, &stime, &vsize, &rss);
-    
-    proc->state = state;
-    proc->vsz = vsize / 1024; // KB로 변환
-    proc->rss = rss * 4; // 페이지 크기 4KB로 가정
-    
-    // 명령어 이름에서 괄호 제거
-    if (comm[0] == '(') {
-        strncpy(proc->cmd, comm + 1, sizeof(proc->cmd) - 1);
-        proc->cmd[strlen(proc->cmd) - 1] = '\0'; // 마지막 ')' 제거
-    } else {
-        strncpy(proc->cmd, comm, sizeof(proc->cmd) - 1);
-    }
+    ProcStat st;
+    
+    if (procfs_read_stat(pid, NULL, &st) != 0) return -1;
     
-    fclose(file);
+    proc->pid = st.pid;
+    proc->state = st.state;
+    proc->vsz = st.vsize / 1024; // KB로 변환
+    proc->rss = st.rss * procfs_page_kb();
+    snprintf(proc->cmd, sizeof(proc->cmd), "%s", st.comm);
     return 0;
 }
 
 // /proc/pid/status 파일에서 사용자 정보 읽기
 int read_proc_status(int pid, ProcessInfo *proc) {
-    char path[MAX_PATH_LEN];
-    FILE *file;
-    char line[256];
-    uid_t uid = -1;
-    
-    snprintf(path, sizeof(path), "/proc/%d/status", pid);
-    file = fopen(path, "r");
-    if (!file) return -1;
-    
-    while (fgets(line, sizeof(line), file)) {
-        if (strncmp(line, "Uid:", 4) == 0) {
-            sscanf(line, "Uid:\t%d", &uid);
-            break;
-        }
-    }
-    fclose(file);
-    
-    if (uid != -1) {
-        struct passwd *pw = getpwuid(uid);
-        if (pw) {
-            strncpy(proc->user, pw->pw_name, sizeof(proc->user) - 1);
-        } else {
-            snprintf(proc->user, sizeof(proc->user), "%d", uid);
-        }
-    } else {
-        strcpy(proc->user, "unknown");
-    }
+    uid_t uid;
     
+    if (procfs_read_uid(pid, &uid) != 0) return -1;
+    
+    procfs_user_name(uid, proc->user, sizeof(proc->user));
     return 0;
 }
 
-// 메모리 사용률 계산
+// 메모리 사용률 계산 (MemTotal은 명령을 실행할 때마다 refresh_mem_total로 한 번만 읽음)
+static long mem_total_kb = 0;
+
+void refresh_mem_total(void) {
+    ProcMeminfo mi;
+    mem_total_kb = procfs_read_meminfo(&mi) == 0 ? mi.total : 0;
+}
+
 float calculate_mem_percent(long rss) {
-    FILE *file = fopen("/proc/meminfo", "r");
-    if (!file) return 0.0;
-    
-    char line[256];
-    long total_mem = 0;
-    
-    while (fgets(line, sizeof(line), file)) {
-        if (strncmp(line, "MemTotal:", 9) == 0) {
-            sscanf(line, "MemTotal: %ld kB", &total_mem);
-            break;
-        }
-    }
-    fclose(file);
-    
-    if (total_mem > 0) {
-        return ((float)rss / total_mem) * 100.0;
+    if (mem_total_kb > 0) {
+        return ((float)rss / mem_total_kb) * 100.0;
     }
     return 0.0;
 }
@@ -150,6 +101,8 @@ void ps_command(int show_all) {
         return;
     }
     
+    refresh_mem_total();
+    
     if (show_all) {
         printf("USER       PID %%CPU %%MEM    VSZ   RSS TTY      STAT START   TIME COMMAND\n");
     } else {
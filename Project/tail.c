@@ -1,3 +1,4 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -5,170 +6,671 @@
 #include <sys/stat.h>
 #include <errno.h>
 #include <getopt.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/inotify.h>
 
-#define MAX_LINE_LENGTH 4096
 #define DEFAULT_LINES 10
+#define BLOCK_SIZE (64 * 1024)   // 역방향 탐색/복사 블록 크기
 
+// 추적 중인 파일 자체와 부모 디렉토리에서 받을 inotify 이벤트
+#define FILE_EVENTS (IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF)
+#define DIR_EVENTS (IN_CREATE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM)
+
+enum follow_mode { FOLLOW_NONE, FOLLOW_DESCRIPTOR, FOLLOW_NAME };
+
+// 출력할 범위 (-n/-c NUM, +NUM이면 처음부터 센 위치)
 typedef struct {
-    char **lines;
-    int count;
-    int capacity;
-} LineBuffer;
-
-// 라인 버퍼 초기화
-LineBuffer* create_line_buffer(int capacity) {
-    LineBuffer *buf = malloc(sizeof(LineBuffer));
-    buf->lines = malloc(sizeof(char*) * capacity);
-    buf->count = 0;
-    buf->capacity = capacity;
-    return buf;
-}
-
-// 라인 버퍼 해제
-void free_line_buffer(LineBuffer *buf) {
-    for (int i = 0; i < buf->count; i++) {
-        free(buf->lines[i]);
-    }
-    free(buf->lines);
-    free(buf);
+    long long count;   // 줄 수 또는 바이트 수
+    int bytes;         // -c: 바이트 단위
+    int from_start;    // +N: N번째부터 끝까지
+} TailSpec;
+
+// 파이프 입력의 꼬리를 담는 바이트 링 (용량은 2의 거듭제곱, 위치는 스트림 기준)
+typedef struct {
+    char *data;
+    size_t capacity;
+    unsigned long long begin;   // 아직 필요한 첫 바이트 위치
+    unsigned long long end;     // 지금까지 읽은 바이트 수
+} ByteRing;
+
+// -f/-F로 추적 중인 파일
+typedef struct {
+    const char *name;
+    const char *base;   // 디렉토리 이벤트와 비교할 파일 이름 부분
+    char *dir;          // 부모 디렉토리 (이름 추적 시)
+    int fd;             // -1이면 현재 열려 있지 않음
+    off_t pos;          // 다음에 읽을 위치
+    dev_t dev;
+    ino_t ino;
+    int wd;             // 파일 inotify watch
+    int dir_wd;         // 부모 디렉토리 inotify watch
+} FollowFile;
+
+static int last_shown = -1;   // 마지막으로 출력한 파일 (헤더 출력 여부 판단)
+
+// 버퍼 전체를 fd에 씀
+static int write_all(int fd, const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t written = write(fd, buf, len);
+        if (written == -1) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        buf += written;
+        len -= written;
+    }
+    return 0;
 }
 
-// 라인 추가 (링 버퍼 방식)
-void add_line(LineBuffer *buf, const char *line) {
-    if (buf->count < buf->capacity) {
-        buf->lines[buf->count] = strdup(line);
-        buf->count++;
-    } else {
-        // 가장 오래된 라인 제거하고 새 라인 추가
-        free(buf->lines[0]);
-        for (int i = 0; i < buf->capacity - 1; i++) {
-            buf->lines[i] = buf->lines[i + 1];
+// fd의 from 위치부터 end까지 표준출력으로 복사
+static int copy_range(int fd, off_t from, off_t end, char *buf) {
+    while (from < end) {
+        size_t chunk = end - from < BLOCK_SIZE ? (size_t)(end - from) : BLOCK_SIZE;
+        ssize_t nread = pread(fd, buf, chunk, from);
+        if (nread == -1 && errno == EINTR) continue;
+        if (nread <= 0) return -1;
+        if (write_all(STDOUT_FILENO, buf, nread) < 0) return -1;
+        from += nread;
+    }
+    return 0;
+}
+
+// 일반 파일의 마지막 n줄 출력
+// 파일 끝에서부터 블록 단위로 거꾸로 읽으며 memrchr로 개행을 세고,
+// n번째 개행 다음 위치부터 끝까지를 그대로 표준출력에 씀 (파일 크기와 무관하게 끝부분만 읽음)
+static int tail_lines_backward(const char *filename, int fd, off_t size, long long n, char *buf) {
+    if (n == 0) return 0;
+
+    off_t pos = size;
+    off_t start = 0;
+    long long remaining = n;
+    int skip_last_newline = 1;   // 파일 마지막 개행은 마지막 줄의 끝이므로 세지 않음
+    int found = 0;
+
+    while (pos > 0 && !found) {
+        size_t chunk = pos < BLOCK_SIZE ? (size_t)pos : BLOCK_SIZE;
+        pos -= chunk;
+
+        ssize_t nread = pread(fd, buf, chunk, pos);
+        if (nread != (ssize_t)chunk) {
+            if (nread == -1 && errno == EINTR) {
+                pos += chunk;
+                continue;
+            }
+            fprintf(stderr, "tail: error reading '%s': %s\n", filename,
+                    nread == -1 ? strerror(errno) : "unexpected end of file");
+            return -1;
+        }
+
+        size_t len = chunk;
+        if (skip_last_newline) {
+            if (buf[len - 1] == '\n') len--;
+            skip_last_newline = 0;
+        }
+
+        // 블록 안에서 뒤에서부터 개행 검색
+        char *p;
+        while (len > 0 && (p = memrchr(buf, '\n', len)) != NULL) {
+            if (--remaining == 0) {
+                start = pos + (p - buf) + 1;
+                found = 1;
+                break;
+            }
+            len = p - buf;
+        }
+    }
+
+    fflush(stdout);
+    int result = copy_range(fd, start, size, buf);
+    if (result < 0) {
+        fprintf(stderr, "tail: error writing '%s': %s\n", filename, strerror(errno));
+    }
+    return result;
+}
+
+// 스트림 위치 pos의 바이트가 들어갈 링 인덱스
+#define RING_INDEX(ring, pos) ((size_t)(pos) & ((ring)->capacity - 1))
+
+// 링에 남은 내용이 extra 바이트를 더 받을 수 있도록 확장 (순서를 유지해 새 버퍼로 옮김)
+static int ring_reserve(ByteRing *ring, size_t extra) {
+    size_t used = ring->end - ring->begin;
+    if (used + extra <= ring->capacity) return 0;
+
+    size_t capacity = ring->capacity ? ring->capacity : BLOCK_SIZE;
+    while (capacity < used + extra) capacity *= 2;
+
+    char *data = malloc(capacity);
+    if (!data) return -1;
+    for (unsigned long long pos = ring->begin; pos < ring->end; ) {
+        size_t idx = RING_INDEX(ring, pos);
+        size_t chunk = ring->capacity - idx;
+        if (chunk > ring->end - pos) chunk = ring->end - pos;
+        memcpy(data + (pos & (capacity - 1)), ring->data + idx, chunk);
+        pos += chunk;
+    }
+    free(ring->data);
+    ring->data = data;
+    ring->capacity = capacity;
+    return 0;
+}
+
+// 새로 읽은 바이트를 링 끝에 추가
+static void ring_append(ByteRing *ring, const char *buf, size_t len) {
+    while (len > 0) {
+        size_t idx = RING_INDEX(ring, ring->end);
+        size_t chunk = ring->capacity - idx;
+        if (chunk > len) chunk = len;
+        memcpy(ring->data + idx, buf, chunk);
+        ring->end += chunk;
+        buf += chunk;
+        len -= chunk;
+    }
+}
+
+// 링의 from 위치부터 끝까지 표준출력으로 씀
+static int ring_write(ByteRing *ring, unsigned long long from) {
+    while (from < ring->end) {
+        size_t idx = RING_INDEX(ring, from);
+        size_t chunk = ring->capacity - idx;
+        if (chunk > ring->end - from) chunk = ring->end - from;
+        if (write_all(STDOUT_FILENO, ring->data + idx, chunk) < 0) return -1;
+        from += chunk;
+    }
+    return 0;
+}
+
+// 파이프/표준입력의 마지막 N줄(또는 N바이트) 출력
+// 읽은 바이트는 크기가 자라는 링에 두고, 최근 N+1개 개행 위치를 원형 배열로 유지해
+// 필요 없는 앞부분은 바로 버림 (메모리는 출력할 꼬리 크기 + 읽기 블록 하나로 제한)
+// 개행 배열도 작게 시작해 실제로 본 개행 수만큼만 두 배씩 늘림 (최대 N+1칸)
+static int tail_pipe(const char *filename, int fd, const TailSpec *spec, char *buf) {
+    ByteRing ring = {0};
+    unsigned long long *newlines = NULL;   // 최근 개행 위치 (원형)
+    long long slots = spec->bytes ? 0 : spec->count + 1;
+    long long capacity = 0;                 // newlines 칸 수 (slots보다 작으면 아직 한 바퀴 돌지 않음)
+    long long seen = 0;                     // 지금까지 본 개행 수
+    int result = 0;
+
+    if (spec->count == 0) return 0;
+
+    for (;;) {
+        ssize_t nread = read(fd, buf, BLOCK_SIZE);
+        if (nread == -1 && errno == EINTR) continue;
+        if (nread == -1) {
+            fprintf(stderr, "tail: error reading '%s': %s\n", filename, strerror(errno));
+            result = -1;
+            break;
+        }
+        if (nread == 0) break;
+
+        if (ring_reserve(&ring, nread) < 0) {
+            perror("tail");
+            result = -1;
+            break;
+        }
+        unsigned long long base = ring.end;
+        ring_append(&ring, buf, nread);
+
+        if (spec->bytes) {
+            // 마지막 N바이트만 남김
+            if (ring.end - ring.begin > (unsigned long long)spec->count) {
+                ring.begin = ring.end - spec->count;
+            }
+            continue;
+        }
+
+        // 새 블록의 개행 위치 기록, 가장 오래된 개행 이전 바이트는 버림
+        for (char *p = buf; (p = memchr(p, '\n', buf + nread - p)) != NULL; p++) {
+            if (seen == capacity && capacity < slots) {
+                // 아직 돌지 않았으므로 늘려도 기존 위치는 그대로 유효함
+                long long grown = capacity ? capacity * 2 : 1024;
+                if (grown > slots) grown = slots;
+                unsigned long long *bigger = realloc(newlines, grown * sizeof(*newlines));
+                if (!bigger) {
+                    perror("tail");
+                    result = -1;
+                    break;
+                }
+                newlines = bigger;
+                capacity = grown;
+            }
+            newlines[seen % capacity] = base + (p - buf);
+            seen++;
+        }
+        if (result < 0) break;
+        if (seen >= slots) {
+            ring.begin = newlines[seen % capacity] + 1;
+        }
+    }
+
+    if (result == 0 && ring.end > ring.begin) {
+        unsigned long long start = ring.begin;
+        if (!spec->bytes) {
+            // 마지막 개행은 마지막 줄의 끝이므로 세지 않음
+            long long usable = seen;
+            if (usable > 0 && newlines[(seen - 1) % capacity] == ring.end - 1) usable--;
+            start = usable >= spec->count
+                ? newlines[(usable - spec->count) % capacity] + 1 : ring.begin;
+        }
+        fflush(stdout);
+        if (ring_write(&ring, start) < 0) {
+            fprintf(stderr, "tail: error writing '%s': %s\n", filename, strerror(errno));
+            result = -1;
+        }
+    }
+
+    free(ring.data);
+    free(newlines);
+    return result;
+}
+
+// +N: N번째 줄(또는 바이트)부터 끝까지 순서대로 읽어 출력
+static int tail_from_start(const char *filename, int fd, const TailSpec *spec, char *buf) {
+    long long skip = spec->count > 0 ? spec->count - 1 : 0;   // 건너뛸 줄/바이트 수
+
+    fflush(stdout);
+    for (;;) {
+        ssize_t nread = read(fd, buf, BLOCK_SIZE);
+        if (nread == -1 && errno == EINTR) continue;
+        if (nread == -1) {
+            fprintf(stderr, "tail: error reading '%s': %s\n", filename, strerror(errno));
+            return -1;
+        }
+        if (nread == 0) return 0;
+
+        char *p = buf;
+        if (skip > 0) {
+            if (spec->bytes) {
+                long long n = skip < nread ? skip : nread;
+                p += n;
+                skip -= n;
+            } else {
+                char *nl;
+                while (skip > 0 && (nl = memchr(p, '\n', buf + nread - p)) != NULL) {
+                    p = nl + 1;
+                    skip--;
+                }
+                if (skip > 0) p = buf + nread;
+            }
+        }
+        if (p < buf + nread && write_all(STDOUT_FILENO, p, buf + nread - p) < 0) {
+            fprintf(stderr, "tail: error writing '%s': %s\n", filename, strerror(errno));
+            return -1;
         }
-        buf->lines[buf->capacity - 1] = strdup(line);
     }
 }
 
-// 파일의 마지막 n줄 읽기
-int read_last_lines(const char *filename, int n) {
-    FILE *file = fopen(filename, "r");
-    if (!file) {
+// 이미 연 파일에 대해 옵션에 맞는 꼬리 부분 출력
+// 크기를 아는 일반 파일은 필요한 부분만 읽고, 그 외는 스트림으로 처리
+static int tail_fd(const char *filename, int fd, const TailSpec *spec) {
+    char *buf = malloc(BLOCK_SIZE);
+    struct stat st;
+    int result;
+
+    if (!buf) {
+        perror("tail");
+        return -1;
+    }
+
+    int regular = fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 &&
+                  lseek(fd, 0, SEEK_CUR) == 0;
+
+    if (regular && !spec->from_start && !spec->bytes) {
+        result = tail_lines_backward(filename, fd, st.st_size, spec->count, buf);
+    } else if (regular && spec->bytes) {
+        // 바이트 단위는 위치 계산만으로 충분
+        off_t start = spec->from_start
+            ? (spec->count > 0 ? spec->count - 1 : 0)
+            : (st.st_size > spec->count ? st.st_size - spec->count : 0);
+        fflush(stdout);
+        result = copy_range(fd, start, st.st_size, buf);
+        if (result < 0) {
+            fprintf(stderr, "tail: error reading '%s': %s\n", filename, strerror(errno));
+        }
+    } else if (spec->from_start) {
+        result = tail_from_start(filename, fd, spec, buf);
+    } else {
+        result = tail_pipe(filename, fd, spec, buf);
+    }
+
+    free(buf);
+    return result;
+}
+
+// 파일 이름("-"는 표준입력)으로 열어 꼬리 부분 출력
+int tail_file(const char *filename, const TailSpec *spec) {
+    if (strcmp(filename, "-") == 0) {
+        return tail_fd("standard input", STDIN_FILENO, spec);
+    }
+
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1) {
         fprintf(stderr, "tail: cannot open '%s' for reading: %s\n", 
                 filename, strerror(errno));
         return -1;
     }
 
-    LineBuffer *buf = create_line_buffer(n);
-    char line[MAX_LINE_LENGTH];
+    int result = tail_fd(filename, fd, spec);
+    close(fd);
+    return result;
+}
+
+// 헤더와 메시지에 쓸 이름 ("-"는 표준입력)
+static const char *display_name(const char *name) {
+    return strcmp(name, "-") == 0 ? "standard input" : name;
+}
+
+// 추적 중인 파일의 다음 내용을 출력할 때 필요하면 "==> 파일 <==" 헤더 출력
+static void show_follow_header(FollowFile *files, int count, int idx) {
+    if (count > 1 && idx != last_shown) {
+        printf("\n==> %s <==\n", display_name(files[idx].name));
+        fflush(stdout);
+    }
+    last_shown = idx;
+}
+
+// 마지막으로 읽은 위치 이후에 추가된 내용을 큰 블록 단위로 읽어 출력
+static void read_appended(FollowFile *files, int count, int idx, char *buf) {
+    FollowFile *f = &files[idx];
+    struct stat st;
+
+    if (f->fd == -1) return;
 
-    // 파일의 모든 라인을 읽으면서 마지막 n줄만 버퍼에 유지
-    while (fgets(line, sizeof(line), file)) {
-        add_line(buf, line);
+    // 크기가 줄었으면 잘린 것으로 보고 처음부터 다시 읽음
+    if (fstat(f->fd, &st) == 0 && st.st_size < f->pos) {
+        fprintf(stderr, "tail: %s: file truncated\n", display_name(f->name));
+        f->pos = 0;
     }
 
-    // 버퍼의 내용 출력
-    for (int i = 0; i < buf->count; i++) {
-        printf("%s", buf->lines[i]);
+    for (;;) {
+        ssize_t nread = pread(f->fd, buf, BLOCK_SIZE, f->pos);
+        if (nread == -1 && errno == EINTR) continue;
+        if (nread <= 0) break;
+        show_follow_header(files, count, idx);
+        if (write_all(STDOUT_FILENO, buf, nread) < 0) {
+            perror("tail: write error");
+            exit(1);
+        }
+        f->pos += nread;
     }
+}
+
+// 이름으로 파일을 열고 inotify watch 등록 (fd와 inode 정보 갱신)
+// 표준입력은 다시 열지 않고 fd를 복제해 쓰고, watch는 /proc의 fd 링크로 등록
+static int open_follow(FollowFile *f, int inotify_fd) {
+    struct stat st;
+    int is_stdin = strcmp(f->name, "-") == 0;
 
-    free_line_buffer(buf);
-    fclose(file);
+    f->fd = is_stdin ? dup(STDIN_FILENO) : open(f->name, O_RDONLY);
+    if (f->fd == -1) return -1;
+    if (fstat(f->fd, &st) == -1) {
+        close(f->fd);
+        f->fd = -1;
+        return -1;
+    }
+    f->dev = st.st_dev;
+    f->ino = st.st_ino;
+    f->pos = 0;
+    if (inotify_fd != -1) {
+        f->wd = inotify_add_watch(inotify_fd, is_stdin ? "/proc/self/fd/0" : f->name, FILE_EVENTS);
+    }
     return 0;
 }
 
-// 파일 크기 가져오기
-long get_file_size(const char *filename) {
+// 추적 중인 파일 닫기
+static void close_follow(FollowFile *f, int inotify_fd) {
+    if (f->wd != -1 && inotify_fd != -1) {
+        inotify_rm_watch(inotify_fd, f->wd);
+    }
+    f->wd = -1;
+    if (f->fd != -1) {
+        close(f->fd);
+        f->fd = -1;
+    }
+}
+
+// 이름 추적 모드: 이름이 가리키는 파일이 바뀌었는지 확인 (로테이션, 삭제, 재생성)
+static void check_name(FollowFile *files, int count, int idx, int inotify_fd, char *buf) {
+    FollowFile *f = &files[idx];
     struct stat st;
-    if (stat(filename, &st) == 0) {
-        return st.st_size;
+
+    // 표준입력은 이름이 없으므로 열어 둔 fd만 따라감
+    if (strcmp(f->name, "-") == 0) return;
+
+    if (stat(f->name, &st) == -1) {
+        int saved_errno = errno;
+        if (f->fd != -1) {
+            read_appended(files, count, idx, buf);
+            fprintf(stderr, "tail: '%s' has become inaccessible: %s\n",
+                    f->name, strerror(saved_errno));
+            close_follow(f, inotify_fd);
+        }
+        return;
+    }
+
+    if (f->fd != -1 && st.st_dev == f->dev && st.st_ino == f->ino) {
+        return;
+    }
+
+    // 이전 파일에 남은 내용을 마저 출력한 뒤 새 파일을 처음부터 따라감
+    if (f->fd != -1) {
+        read_appended(files, count, idx, buf);
+        close_follow(f, inotify_fd);
+        fprintf(stderr, "tail: '%s' has been replaced;  following new file\n", f->name);
+    } else {
+        fprintf(stderr, "tail: '%s' has appeared;  following new file\n", f->name);
+    }
+    if (open_follow(f, inotify_fd) == 0) {
+        read_appended(files, count, idx, buf);
     }
-    return -1;
 }
 
-// 파일 실시간 모니터링
-int follow_file(const char *filename, int n) {
-    // 먼저 마지막 n줄 출력
-    if (read_last_lines(filename, n) < 0) {
-        return -1;
+// 부모 디렉토리 경로 (이름 추적 시 생성/이동 이벤트를 받기 위함)
+static char *parent_dir(const char *path) {
+    const char *slash = strrchr(path, '/');
+    if (!slash) return strdup(".");
+    if (slash == path) return strdup("/");
+    return strndup(path, slash - path);
+}
+
+// 여러 파일을 한 프로세스에서 추적 (-f: 파일 디스크립터 기준, -F: 이름 기준)
+// inotify로 변경 이벤트를 기다리고, inotify를 쓸 수 없으면 1초 간격 폴링으로 대체
+int follow_files(char **names, int count, const TailSpec *spec, int mode, int retry) {
+    FollowFile *files = calloc(count, sizeof(FollowFile));
+    char *buf = malloc(BLOCK_SIZE);
+    if (!files || !buf) {
+        perror("tail");
+        return 1;
     }
 
-    FILE *file = fopen(filename, "r");
-    if (!file) {
-        fprintf(stderr, "tail: cannot open '%s' for reading: %s\n", 
-                filename, strerror(errno));
-        return -1;
+    int inotify_fd = inotify_init1(IN_CLOEXEC);
+    int result = 0;
+    int streams = 0;    // 파이프처럼 끝까지 읽고 추적을 마친 입력 수
+
+    // 각 파일의 꼬리 부분을 출력하고 추적 시작 위치 기록
+    for (int i = 0; i < count; i++) {
+        FollowFile *f = &files[i];
+        f->name = names[i];
+        f->fd = -1;
+        f->wd = -1;
+        f->dir_wd = -1;
+        f->base = strrchr(f->name, '/') ? strrchr(f->name, '/') + 1 : f->name;
+
+        if (count > 1) {
+            if (i > 0) printf("\n");
+            printf("==> %s <==\n", display_name(f->name));
+            fflush(stdout);
+        }
+        last_shown = i;
+
+        if (mode == FOLLOW_NAME && inotify_fd != -1 && strcmp(f->name, "-") != 0) {
+            f->dir = parent_dir(f->name);
+            f->dir_wd = inotify_add_watch(inotify_fd, f->dir, DIR_EVENTS);
+        }
+
+        struct stat st;
+        if (open_follow(f, inotify_fd) == -1) {
+            fprintf(stderr, "tail: cannot open '%s' for reading: %s\n",
+                    f->name, strerror(errno));
+            result = 1;
+            continue;
+        }
+        if (fstat(f->fd, &st) == 0 && !S_ISREG(st.st_mode)) {
+            // 파이프, FIFO, 터미널은 다시 열지 않고 열어 둔 fd를 끝(EOF)까지 읽어 출력한 뒤 추적을 마침
+            if (tail_fd(display_name(f->name), f->fd, spec) < 0) result = 1;
+            close_follow(f, inotify_fd);
+            f->dir_wd = -1;
+            streams++;
+            continue;
+        }
+        if (tail_fd(display_name(f->name), f->fd, spec) < 0) {
+            result = 1;
+        }
+        // +N는 순서대로 읽으므로 fstat 이후 추가된 내용까지 이미 출력했을 수 있음
+        off_t offset = lseek(f->fd, 0, SEEK_CUR);
+        f->pos = offset > st.st_size ? offset : st.st_size;
     }
 
-    // 파일 끝으로 이동
-    fseek(file, 0, SEEK_END);
-    long last_size = ftell(file);
+    char events[sizeof(struct inotify_event) * 64 + NAME_MAX + 1]
+        __attribute__((aligned(__alignof__(struct inotify_event))));
 
-    char line[MAX_LINE_LENGTH];
-    
-    while (1) {
-        // 파일 크기 확인
-        long current_size = get_file_size(filename);
-        
-        if (current_size > last_size) {
-            // 새로운 내용이 추가됨
-            while (fgets(line, sizeof(line), file)) {
-                printf("%s", line);
-                fflush(stdout);
+    for (;;) {
+        // 남은 추적 대상이 없으면 종료 (이름 추적 중 --retry면 다시 나타날 때까지 대기)
+        int active = 0;
+        for (int i = 0; i < count; i++) {
+            if (files[i].fd != -1 || (retry && files[i].dir_wd != -1)) active++;
+        }
+        if (active == 0) {
+            // 모두 파이프였다면 끝까지 읽었으므로 조용히 끝냄
+            if (streams < count) {
+                fprintf(stderr, "tail: no files remaining\n");
             }
-            last_size = current_size;
-        } else if (current_size < last_size) {
-            // 파일이 잘렸거나 새로 생성됨
-            fclose(file);
-            file = fopen(filename, "r");
-            if (!file) {
-                fprintf(stderr, "tail: '%s' has been replaced\n", filename);
-                return -1;
+            break;
+        }
+
+        if (inotify_fd == -1) {
+            sleep(1);
+            for (int i = 0; i < count; i++) {
+                if (mode == FOLLOW_NAME) check_name(files, count, i, -1, buf);
+                read_appended(files, count, i, buf);
             }
-            fseek(file, 0, SEEK_END);
-            last_size = ftell(file);
+            continue;
         }
-        
-        // 100ms 대기
-        usleep(100000);
+
+        ssize_t len = read(inotify_fd, events, sizeof(events));
+        if (len == -1) {
+            if (errno == EINTR) continue;
+            perror("tail: inotify");
+            result = 1;
+            break;
+        }
+
+        for (char *p = events; p < events + len; ) {
+            struct inotify_event *ev = (struct inotify_event *)p;
+            p += sizeof(struct inotify_event) + ev->len;
+
+            for (int i = 0; i < count; i++) {
+                FollowFile *f = &files[i];
+
+                if (f->fd != -1 && ev->wd == f->wd) {
+                    if (ev->mask & IN_IGNORED) {
+                        f->wd = -1;
+                    }
+                    if (ev->mask & IN_MODIFY) {
+                        read_appended(files, count, i, buf);
+                    }
+                    if (mode == FOLLOW_NAME && (ev->mask & (IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF))) {
+                        check_name(files, count, i, inotify_fd, buf);
+                    }
+                } else if (mode == FOLLOW_NAME && ev->wd == f->dir_wd && ev->len > 0 &&
+                           strcmp(ev->name, f->base) == 0) {
+                    check_name(files, count, i, inotify_fd, buf);
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        close_follow(&files[i], inotify_fd);
+        free(files[i].dir);
     }
+    if (inotify_fd != -1) close(inotify_fd);
+    free(files);
+    free(buf);
+    return result;
+}
 
-    fclose(file);
+// -n/-c 인자 해석 ("N", "-N": 마지막 N개, "+N": N번째부터)
+static int parse_count(const char *arg, TailSpec *spec) {
+    char *end;
+
+    spec->from_start = arg[0] == '+';
+    if (arg[0] == '+' || arg[0] == '-') arg++;
+    if (!*arg) return -1;
+
+    errno = 0;
+    spec->count = strtoll(arg, &end, 10);
+    if (errno != 0 || *end != '\0' || spec->count < 0) return -1;
     return 0;
 }
 
 void print_usage(const char *prog_name) {
     printf("Usage: %s [OPTION]... [FILE]...\n", prog_name);
     printf("Print the last 10 lines of each FILE to standard output.\n");
-    printf("With more than one FILE, precede each with a header giving the file name.\n\n");
+    printf("With more than one FILE, precede each with a header giving the file name.\n");
+    printf("With no FILE, or when FILE is -, read standard input.\n\n");
     printf("Options:\n");
-    printf("  -n, --lines=NUM     output the last NUM lines, instead of the last 10\n");
-    printf("  -f, --follow        output appended data as the file grows\n");
+    printf("  -c, --bytes=[+]NUM  output the last NUM bytes; or use -c +NUM to\n");
+    printf("                      output starting with byte NUM of each file\n");
+    printf("  -n, --lines=[+]NUM  output the last NUM lines, instead of the last 10;\n");
+    printf("                      or use -n +NUM to output starting with line NUM\n");
+    printf("  -f, --follow[={name|descriptor}]\n");
+    printf("                      output appended data as the file grows;\n");
+    printf("                      -f and --follow follow the descriptor\n");
+    printf("  -F                  same as --follow=name with retry\n");
     printf("  -h, --help          display this help and exit\n");
 }
 
 int main(int argc, char *argv[]) {
-    int n = DEFAULT_LINES;
-    int follow = 0;
+    TailSpec spec = { DEFAULT_LINES, 0, 0 };
+    int follow = FOLLOW_NONE;
+    int retry = 0;
     int opt;
     
     static struct option long_options[] = {
+        {"bytes", required_argument, 0, 'c'},
         {"lines", required_argument, 0, 'n'},
-        {"follow", no_argument, 0, 'f'},
+        {"follow", optional_argument, 0, 'f'},
         {"help", no_argument, 0, 'h'},
         {0, 0, 0, 0}
     };
 
     // 옵션 파싱
-    while ((opt = getopt_long(argc, argv, "n:fh", long_options, NULL)) != -1) {
+    while ((opt = getopt_long(argc, argv, "c:n:fFh", long_options, NULL)) != -1) {
         switch (opt) {
+            case 'c':
             case 'n':
-                n = atoi(optarg);
-                if (n <= 0) {
-                    fprintf(stderr, "tail: invalid number of lines: '%s'\n", optarg);
+                if (parse_count(optarg, &spec) < 0) {
+                    fprintf(stderr, "tail: invalid number of %s: '%s'\n",
+                            opt == 'c' ? "bytes" : "lines", optarg);
                     return 1;
                 }
+                spec.bytes = opt == 'c';
                 break;
             case 'f':
-                follow = 1;
+                if (!optarg || strcmp(optarg, "descriptor") == 0) {
+                    follow = FOLLOW_DESCRIPTOR;
+                } else if (strcmp(optarg, "name") == 0) {
+                    follow = FOLLOW_NAME;
+                } else {
+                    fprintf(stderr, "tail: invalid argument '%s' for '--follow'\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'F':
+                follow = FOLLOW_NAME;
+                retry = 1;
                 break;
             case 'h':
                 print_usage(argv[0]);
@@ -180,33 +682,32 @@ int main(int argc, char *argv[]) {
     }
 
     // 파일명이 없으면 표준입력 사용
-    if (optind >= argc) {
-        fprintf(stderr, "tail: missing file operand\n");
-        print_usage(argv[0]);
-        return 1;
+    char *stdin_name[] = { "-" };
+    char **files = argv + optind;
+    int num_files = argc - optind;
+    if (num_files == 0) {
+        files = stdin_name;
+        num_files = 1;
     }
 
-    // 여러 파일 처리
-    int num_files = argc - optind;
     int result = 0;
 
-    for (int i = optind; i < argc; i++) {
-        const char *filename = argv[i];
+    // -f/-F는 모든 파일을 한 번에 추적
+    if (follow != FOLLOW_NONE) {
+        return follow_files(files, num_files, &spec, follow, retry);
+    }
+
+    // 여러 파일 처리
+    for (int i = 0; i < num_files; i++) {
+        const char *filename = files[i];
         
         // 여러 파일일 때 헤더 출력
         if (num_files > 1) {
-            if (i > optind) printf("\n");
-            printf("==> %s <==\n", filename);
+            if (i > 0) printf("\n");
+            printf("==> %s <==\n", strcmp(filename, "-") == 0 ? "standard input" : filename);
         }
 
-        if (follow && i == argc - 1) {
-            // -f 옵션은 마지막 파일에만 적용
-            result = follow_file(filename, n);
-        } else {
-            result = read_last_lines(filename, n);
-        }
-
-        if (result < 0) {
+        if (tail_file(filename, &spec) < 0) {
             result = 1; // 에러 발생
         }
     }
@@ -12,9 +12,18 @@
 #include <termios.h>
 #include <fcntl.h>
 #include <sys/select.h>
+#include <sys/ioctl.h>
+#include <sys/timerfd.h>
+#include <poll.h>
+#include <stdint.h>
+#include "procfs.h"
 
 #define MAX_CMD_LEN 256
 #define MAX_PATH_LEN 512
+#define CPU_HEATMAP_MIN 128         // 코어가 이만큼 이상이면 코어별 보기를 히트맵으로 표시
+#define CPU_HEATMAP_WIDTH 64        // 히트맵 한 줄에 표시할 코어 수
+#define TOP_DEFAULT_DELAY 2.0       // 기본 갱신 간격 (초)
+#define TOP_DEFAULT_ROWS 24         // 터미널 크기를 알 수 없을 때의 화면 줄 수
 
 // 프로세스 정보 구조체
 typedef struct {
@@ -32,6 +41,7 @@ typedef struct {
     unsigned long utime;  // user time
     unsigned long stime;  // system time
     unsigned long total_time; // total time
+    unsigned long long starttime; // 부팅 후 시작 시각 (clock tick)
 } ProcessInfo;
 
 // 시스템 정보 구조체
@@ -49,181 +59,241 @@ typedef struct {
     unsigned long idle_cpu_time;
 } SystemInfo;
 
+// 함수 선언
+int get_process_info(int pid, ProcessInfo *proc);
+void kill_command(int argc, char **args);
+void find_processes_by_name(const char *name);
+void top_command(int argc, char **args);
+
 // 숫자인지 확인하는 함수 (PID 디렉토리 구분용)
 int is_number(const char *str) {
     while (*str) {
         if (*str < '0' || *str > '9') return 0;
         str++;
-    // kill 명령어 처리
-    else if (strcmp(args[0], "kill") == 0) {
-        kill_command(argc, args);
-    // top 명령어 처리
-    else if (strcmp(args[0], "top") == 0) {
-        top_command();
-    }
-    // pgrep 명령어 (프로세스 이름으로 검색)
-    else if (strcmp(args[0], "pgrep") == 0) {
-        if (argc < 2) {
-            printf("Usage: pgrep <process_name>\n");
-        } else {
-            find_processes_by_name(args[1]);
-        }
     }
     return 1;
 }
 
 // /proc/pid/stat 파일에서 프로세스 정보 읽기
-int read_proc_stat(int pid, ProcessInfo *proc) {
-    char path[MAX_PATH_LEN];
-    FILE *file;
-    char comm[256];
-    char state;
-    int ppid, pgrp, session, tty_nr;
-    unsigned long utime, stime, vsize;
-    long rss;
-    
-    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
-    file = fopen(path, "r");
-    if (!file) return -1;
-    
-    // stat 파일의 주요 필드들 읽기
-    fscanf(file, "%d %s %c %d %d %d %d %*d %*u %*u %*u %*u %*u %lu %lu %*d %*d %*d %*d %*d %*d %*u %lu %ld",
-           &proc->pid, comm, &state, &ppid, &pgrp, &session, &tty_nr,
-           &utime, &stime, &vsize, &rss);
-    
-    proc->state = state;
-    proc->vsz = vsize / 1024; // KB로 변환
-    proc->rss = rss * 4; // 페이지 크기 4KB로 가정
-    proc->utime = utime;
-    proc->stime = stime;
-    proc->total_time = utime + stime;
-    
-    // 명령어 이름에서 괄호 제거
-    if (comm[0] == '(') {
-        strncpy(proc->cmd, comm + 1, sizeof(proc->cmd) - 1);
-        proc->cmd[strlen(proc->cmd) - 1] = '\0'; // 마지막 ')' 제거
-    } else {
-        strncpy(proc->cmd, comm, sizeof(proc->cmd) - 1);
-    }
+// 반복해서 읽을 프로세스는 stat_fd에 fd를 열어 두고 재사용함 (한 번만 읽으면 NULL)
+int read_proc_stat(int pid, int *stat_fd, ProcessInfo *proc) {
+    ProcStat st;
+    
+    if (procfs_read_stat(pid, stat_fd, &st) != 0) return -1;
     
-    fclose(file);
+    proc->pid = st.pid;
+    proc->state = st.state;
+    proc->vsz = st.vsize / 1024; // KB로 변환
+    proc->rss = st.rss * procfs_page_kb();
+    proc->utime = st.utime;
+    proc->stime = st.stime;
+    proc->total_time = st.utime + st.stime;
+    proc->starttime = st.starttime;
+    snprintf(proc->cmd, sizeof(proc->cmd), "%s", st.comm);
     return 0;
 }
 
 // /proc/pid/status 파일에서 사용자 정보 읽기
 int read_proc_status(int pid, ProcessInfo *proc) {
-    char path[MAX_PATH_LEN];
-    FILE *file;
-    char line[256];
-    uid_t uid = -1;
-    
-    snprintf(path, sizeof(path), "/proc/%d/status", pid);
-    file = fopen(path, "r");
-    if (!file) return -1;
-    
-    while (fgets(line, sizeof(line), file)) {
-        if (strncmp(line, "Uid:", 4) == 0) {
-            sscanf(line, "Uid:\t%d", &uid);
-            break;
-        }
+    uid_t uid;
+    
+    if (procfs_read_uid(pid, &uid) != 0) return -1;
+    
+    procfs_user_name(uid, proc->user, sizeof(proc->user));
+    return 0;
+}
+
+// 메모리 사용률 계산 (MemTotal은 명령을 실행할 때마다 refresh_mem_total로 한 번만 읽음)
+static long mem_total_kb = 0;
+
+void refresh_mem_total(void) {
+    ProcMeminfo mi;
+    mem_total_kb = procfs_read_meminfo(&mi) == 0 ? mi.total : 0;
+}
+
+float calculate_mem_percent(long rss) {
+    if (mem_total_kb > 0) {
+        return ((float)rss / mem_total_kb) * 100.0;
     }
-    fclose(file);
+    return 0.0;
+}
+
+// /proc/stat cpu 줄 하나의 상태별 누적 시간 (clock tick)
+typedef struct {
+    unsigned long long user;
+    unsigned long long nice;
+    unsigned long long system;
+    unsigned long long idle;
+    unsigned long long iowait;
+    unsigned long long irq;
+    unsigned long long softirq;
+    unsigned long long steal;
+} CpuTimes;
+
+// 두 표본 사이의 상태별 사용률 (%)
+typedef struct {
+    float us, sy, ni, id, wa, hi, si, st;
+} CpuUsage;
+
+// 전체와 코어별 누적 시간 (이전 회차 값과 비교해 구간 사용률을 구함)
+typedef struct {
+    CpuTimes total;
+    CpuTimes prev_total;
+    CpuTimes *cores;                // cpuN의 N으로 색인
+    CpuTimes *prev_cores;
+    unsigned char *online;          // 이번 회차에 cpuN 줄이 있었는지 (꺼진 코어는 줄이 없음)
+    int num_cores;                  // 지금까지 본 가장 큰 N + 1
+    int core_capacity;
+    int num_online;
+} CpuStats;
+
+static unsigned long long cpu_times_sum(const CpuTimes *t) {
+    return t->user + t->nice + t->system + t->idle + t->iowait + t->irq + t->softirq + t->steal;
+}
+
+// "cpu" 라벨 뒤의 숫자 8개를 읽음 (오래된 커널이라 없는 필드는 0)
+static void parse_cpu_times(const char *p, CpuTimes *t) {
+    unsigned long long *field[8] = {
+        &t->user, &t->nice, &t->system, &t->idle,
+        &t->iowait, &t->irq, &t->softirq, &t->steal
+    };
     
-    if (uid != -1) {
-        struct passwd *pw = getpwuid(uid);
-        if (pw) {
-            strncpy(proc->user, pw->pw_name, sizeof(proc->user) - 1);
-        } else {
-            snprintf(proc->user, sizeof(proc->user), "%d", uid);
-        }
-    } else {
-        strcpy(proc->user, "unknown");
+    for (int i = 0; i < 8; i++) {
+        while (*p == ' ') p++;
+        *field[i] = (unsigned long long)procfs_parse_num(&p);
     }
+}
+
+// 코어 배열을 n칸 이상으로 늘림 (새 칸은 0으로 채움)
+static int cpu_stats_reserve(CpuStats *c, int n) {
+    if (n <= c->core_capacity) return 0;
     
+    int capacity = c->core_capacity ? c->core_capacity : 16;
+    while (capacity < n) capacity *= 2;
+    
+    CpuTimes *cores = realloc(c->cores, capacity * sizeof(CpuTimes));
+    if (!cores) return -1;
+    c->cores = cores;
+    CpuTimes *prev_cores = realloc(c->prev_cores, capacity * sizeof(CpuTimes));
+    if (!prev_cores) return -1;
+    c->prev_cores = prev_cores;
+    unsigned char *online = realloc(c->online, capacity);
+    if (!online) return -1;
+    c->online = online;
+    
+    size_t added = capacity - c->core_capacity;
+    memset(c->cores + c->core_capacity, 0, added * sizeof(CpuTimes));
+    memset(c->prev_cores + c->core_capacity, 0, added * sizeof(CpuTimes));
+    memset(c->online + c->core_capacity, 0, added);
+    c->core_capacity = capacity;
     return 0;
 }
 
-// 시스템 정보 읽기
-int get_system_info(SystemInfo *sys_info) {
-    FILE *file;
-    char line[256];
+// /proc/stat의 cpu 줄을 모두 읽음 (지난 값은 prev_total, prev_cores로 옮겨 둠)
+// 처음 읽을 때는 이전 값이 0이므로 부팅 후 전체 구간의 사용률이 됨
+static int cpu_stats_read(CpuStats *c, int *stat_fd) {
+    if (procfs_read_file("/proc/stat", stat_fd) <= 0) return -1;
     
-    // 메모리 정보 읽기
-    file = fopen("/proc/meminfo", "r");
-    if (!file) return -1;
-    
-    sys_info->total_mem = 0;
-    sys_info->free_mem = 0;
-    sys_info->cached_mem = 0;
+    c->prev_total = c->total;
+    if (c->num_cores > 0) {
+        memcpy(c->prev_cores, c->cores, c->num_cores * sizeof(CpuTimes));
+        memset(c->online, 0, c->num_cores);
+    }
+    c->num_online = 0;
     
-    while (fgets(line, sizeof(line), file)) {
-        if (strncmp(line, "MemTotal:", 9) == 0) {
-            sscanf(line, "MemTotal: %ld kB", &sys_info->total_mem);
-        } else if (strncmp(line, "MemFree:", 8) == 0) {
-            sscanf(line, "MemFree: %ld kB", &sys_info->free_mem);
-        } else if (strncmp(line, "Cached:", 7) == 0) {
-            sscanf(line, "Cached: %ld kB", &sys_info->cached_mem);
+    // cpu 줄은 파일 앞쪽에 모여 있음
+    const char *p = procfs_buf;
+    while (p && strncmp(p, "cpu", 3) == 0) {
+        p += 3;
+        if (*p == ' ') {
+            parse_cpu_times(p, &c->total);
+        } else if (*p >= '0' && *p <= '9') {
+            int id = (int)procfs_parse_num(&p);
+            if (cpu_stats_reserve(c, id + 1) == 0) {
+                parse_cpu_times(p, &c->cores[id]);
+                c->online[id] = 1;
+                c->num_online++;
+                if (id + 1 > c->num_cores) c->num_cores = id + 1;
+            }
         }
+        p = strchr(p, '\n');
+        if (p) p++;
     }
-    fclose(file);
-    
-    sys_info->used_mem = sys_info->total_mem - sys_info->free_mem - sys_info->cached_mem;
+    return 0;
+}
+
+static unsigned long long tick_delta(unsigned long long prev, unsigned long long cur) {
+    // 코어가 다시 켜지는 등으로 값이 줄어든 경우는 0으로 봄
+    return cur > prev ? cur - prev : 0;
+}
+
+// prev -> cur 구간의 상태별 사용률
+static void cpu_usage(const CpuTimes *prev, const CpuTimes *cur, CpuUsage *u) {
+    unsigned long long user = tick_delta(prev->user, cur->user);
+    unsigned long long nice = tick_delta(prev->nice, cur->nice);
+    unsigned long long system = tick_delta(prev->system, cur->system);
+    unsigned long long idle = tick_delta(prev->idle, cur->idle);
+    unsigned long long iowait = tick_delta(prev->iowait, cur->iowait);
+    unsigned long long irq = tick_delta(prev->irq, cur->irq);
+    unsigned long long softirq = tick_delta(prev->softirq, cur->softirq);
+    unsigned long long steal = tick_delta(prev->steal, cur->steal);
+    unsigned long long total = user + nice + system + idle + iowait + irq + softirq + steal;
     
-    // Load average 읽기
-    file = fopen("/proc/loadavg", "r");
-    if (file) {
-        fscanf(file, "%f %f %f", &sys_info->load_avg[0], &sys_info->load_avg[1], &sys_info->load_avg[2]);
-        fclose(file);
-    }
-    
-    // CPU 정보 읽기
-    file = fopen("/proc/stat", "r");
-    if (file) {
-        fgets(line, sizeof(line), file);
-        unsigned long user, nice, system, idle, iowait, irq, softirq, steal;
-        sscanf(line, "cpu %lu %lu %lu %lu %lu %lu %lu %lu",
-               &user, &nice, &system, &idle, &iowait, &irq, &softirq, &steal);
-        
-        sys_info->total_cpu_time = user + nice + system + idle + iowait + irq + softirq + steal;
-        sys_info->idle_cpu_time = idle + iowait;
-        fclose(file);
+    if (total == 0) {
+        memset(u, 0, sizeof(*u));
+        u->id = 100.0;
+        return;
     }
     
-    return 0;
+    float scale = 100.0 / total;
+    u->us = user * scale;
+    u->sy = system * scale;
+    u->ni = nice * scale;
+    u->id = idle * scale;
+    u->wa = iowait * scale;
+    u->hi = irq * scale;
+    u->si = softirq * scale;
+    u->st = steal * scale;
 }
 
-// 프로세스 수 계산
-void count_processes(SystemInfo *sys_info) {
-    DIR *proc_dir;
-    struct dirent *entry;
-    ProcessInfo proc;
+void free_cpu_stats(CpuStats *c) {
+    free(c->cores);
+    free(c->prev_cores);
+    free(c->online);
+    memset(c, 0, sizeof(*c));
+}
+
+// 시스템 정보 읽기 (meminfo, loadavg, stat fd는 열어 두고 갱신마다 다시 읽음)
+static int loadavg_fd = -1;
+static int cpu_stat_fd = -1;
+
+int get_system_info(SystemInfo *sys_info, CpuStats *cpu) {
+    ProcMeminfo mi;
     
-    sys_info->num_processes = 0;
-    sys_info->num_running = 0;
-    sys_info->num_sleeping = 0;
-    sys_info->num_zombie = 0;
+    // 메모리 정보 읽기
+    if (procfs_read_meminfo(&mi) != 0) return -1;
     
-    proc_dir = opendir("/proc");
-    if (!proc_dir) return;
+    sys_info->total_mem = mi.total;
+    sys_info->free_mem = mi.free;
+    sys_info->cached_mem = mi.cached;
+    sys_info->used_mem = sys_info->total_mem - sys_info->free_mem - sys_info->cached_mem;
+    mem_total_kb = mi.total;
     
-    while ((entry = readdir(proc_dir)) != NULL) {
-        if (!is_number(entry->d_name)) continue;
-        
-        int pid = atoi(entry->d_name);
-        if (read_proc_stat(pid, &proc) == 0) {
-            sys_info->num_processes++;
-            switch (proc.state) {
-                case 'R': sys_info->num_running++; break;
-                case 'S': case 'D': sys_info->num_sleeping++; break;
-                case 'Z': sys_info->num_zombie++; break;
-            }
-        }
+    // Load average 읽기
+    if (procfs_read_file("/proc/loadavg", &loadavg_fd) > 0) {
+        sscanf(procfs_buf, "%f %f %f", &sys_info->load_avg[0], &sys_info->load_avg[1], &sys_info->load_avg[2]);
     }
     
-    closedir(proc_dir);
+    // CPU 정보 읽기 (프로세스 %CPU는 전체 코어의 tick 합을 기준으로 계산)
+    if (cpu_stats_read(cpu, &cpu_stat_fd) == 0) {
+        sys_info->total_cpu_time = cpu_times_sum(&cpu->total);
+        sys_info->idle_cpu_time = cpu->total.idle + cpu->total.iowait;
+    }
+    
+    return 0;
 }
 
-// 터미널 설정 변경 (non-blocking input)
+// 터미널 설정 변경 (키를 한 글자씩 바로 받음, 읽을 때가 되었는지는 poll로 확인)
 void set_terminal_mode(int enable) {
     static struct termios old_termios;
     static int is_set = 0;
@@ -233,11 +303,9 @@ void set_terminal_mode(int enable) {
         struct termios new_termios = old_termios;
         new_termios.c_lflag &= ~(ICANON | ECHO);
         tcsetattr(STDIN_FILENO, TCSANOW, &new_termios);
-        fcntl(STDIN_FILENO, F_SETFL, O_NONBLOCK);
         is_set = 1;
     } else if (!enable && is_set) {
         tcsetattr(STDIN_FILENO, TCSANOW, &old_termios);
-        fcntl(STDIN_FILENO, F_SETFL, 0);
         is_set = 0;
     }
 }
@@ -248,150 +316,669 @@ void clear_screen() {
     fflush(stdout);
 }
 
-// CPU 사용률 계산을 위한 이전 값들 저장
-static unsigned long prev_total_time[1000] = {0};
-static unsigned long prev_cpu_total = 0;
-static unsigned long prev_cpu_idle = 0;
+// CPU 사용률 계산을 위한 프로세스별 이전 값
+// pid는 재사용되므로 시작 시각이 달라지면 새 프로세스로 보고 이전 프로세스의 값을 물려받지 않게 함
+typedef struct {
+    int pid;                        // 0이면 빈 칸
+    unsigned long long starttime;
+    unsigned long prev_total_time;
+    unsigned int seen;              // 마지막으로 본 표본 회차
+    int stat_fd;                    // 열어 둔 /proc/pid/stat (-1이면 없음)
+} SampleEntry;
+
+// 프로세스 표본 수집기: 해시 테이블은 갱신 사이에 유지하고 프로세스 목록은 필요한 만큼 늘림
+typedef struct {
+    SampleEntry *slots;             // 열린 주소법 해시 테이블 (크기는 2의 거듭제곱)
+    size_t capacity;
+    size_t count;
+    unsigned int generation;        // 표본 회차 (1부터)
+    unsigned long prev_cpu_total;
+    
+    ProcessInfo *procs;             // 이번 회차에 읽은 프로세스
+    size_t proc_count;
+    size_t proc_capacity;
+    ProcessInfo **order;            // 표시 순서 (앞쪽 top_n개만 정렬됨)
+    size_t order_capacity;
+} Sampler;
 
-// CPU 사용률 계산
-float calculate_cpu_usage(ProcessInfo *proc, unsigned long total_cpu_time, unsigned long idle_cpu_time) {
-    static int first_call = 1;
+static size_t sample_hash(const Sampler *s, int pid) {
+    unsigned long long h = (unsigned long long)pid * 0x9E3779B97F4A7C15ULL;
+    h ^= h >> 31;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 29;
+    return (size_t)h & (s->capacity - 1);
+}
+
+// 해시 테이블 크기를 두 배로 늘리고 다시 배치
+static int sampler_grow(Sampler *s) {
+    size_t old_capacity = s->capacity;
+    SampleEntry *old = s->slots;
+    size_t capacity = old_capacity ? old_capacity * 2 : 1024;
+    
+    SampleEntry *slots = calloc(capacity, sizeof(SampleEntry));
+    if (!slots) return -1;
+    s->slots = slots;
+    s->capacity = capacity;
     
-    if (first_call) {
-        prev_total_time[proc->pid % 1000] = proc->total_time;
-        prev_cpu_total = total_cpu_time;
-        prev_cpu_idle = idle_cpu_time;
-        first_call = 0;
-        return 0.0;
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old[i].pid == 0) continue;
+        size_t j = sample_hash(s, old[i].pid);
+        while (s->slots[j].pid != 0) {
+            j = (j + 1) & (capacity - 1);
+        }
+        s->slots[j] = old[i];
+    }
+    free(old);
+    return 0;
+}
+
+// pid 항목 찾기, 없으면 새로 만듦 (*created에 새로 만들었는지 기록)
+static SampleEntry *sampler_lookup(Sampler *s, int pid, int *created) {
+    // 채움 비율을 70% 이하로 유지
+    if ((s->count + 1) * 10 > s->capacity * 7 && sampler_grow(s) != 0) {
+        return NULL;
     }
     
-    unsigned long proc_time_diff = proc->total_time - prev_total_time[proc->pid % 1000];
-    unsigned long cpu_time_diff = total_cpu_time - prev_cpu_total;
+    size_t i = sample_hash(s, pid);
+    while (s->slots[i].pid != 0) {
+        if (s->slots[i].pid == pid) {
+            *created = 0;
+            return &s->slots[i];
+        }
+        i = (i + 1) & (s->capacity - 1);
+    }
     
-    prev_total_time[proc->pid % 1000] = proc->total_time;
+    s->slots[i].pid = pid;
+    s->slots[i].starttime = 0;
+    s->slots[i].prev_total_time = 0;
+    s->slots[i].stat_fd = -1;
+    s->count++;
+    *created = 1;
+    return &s->slots[i];
+}
+
+// i번 칸을 비우고 뒤따르는 항목들을 앞으로 당겨 탐색 경로를 유지 (묘비 없이 삭제)
+static void sampler_remove_slot(Sampler *s, size_t i) {
+    size_t mask = s->capacity - 1;
+    size_t j = i;
     
-    if (cpu_time_diff > 0) {
-        return ((float)proc_time_diff / cpu_time_diff) * 100.0;
+    for (;;) {
+        j = (j + 1) & mask;
+        if (s->slots[j].pid == 0) break;
+        
+        // j의 원래 자리 k가 (i, j] 구간 밖이면 i로 옮길 수 있음
+        size_t k = sample_hash(s, s->slots[j].pid);
+        int movable = (i <= j) ? (k <= i || k > j) : (k <= i && k > j);
+        if (movable) {
+            s->slots[i] = s->slots[j];
+            i = j;
+        }
     }
-    return 0.0;
+    s->slots[i].pid = 0;
+    s->count--;
 }
 
-// top 명령어 구현
-void top_command() {
-    SystemInfo sys_info;
-    ProcessInfo processes[100];  // 최대 100개 프로세스 표시
-    int process_count = 0;
+// 이번 회차에 보이지 않은 (종료된) 프로세스 항목 정리 (열어 둔 fd도 닫음)
+static void sampler_collect(Sampler *s) {
+    size_t i = 0;
+    
+    while (i < s->capacity) {
+        if (s->slots[i].pid != 0 && s->slots[i].seen != s->generation) {
+            procfs_close(&s->slots[i].stat_fd);
+            // 당겨 온 항목이 이 칸에 들어올 수 있으므로 같은 칸을 다시 확인
+            sampler_remove_slot(s, i);
+        } else {
+            i++;
+        }
+    }
+}
+
+// /proc을 한 번 훑어 모든 프로세스의 CPU 사용률과 상태별 개수를 구함
+// (사용자 이름 등 표시에만 필요한 정보는 화면에 나올 프로세스만 따로 읽음)
+void sample_processes(Sampler *s, SystemInfo *sys_info) {
+    DIR *proc_dir;
+    struct dirent *entry;
     
-    set_terminal_mode(1);  // non-blocking 모드 활성화
+    s->generation++;
+    s->proc_count = 0;
+    sys_info->num_processes = 0;
+    sys_info->num_running = 0;
+    sys_info->num_sleeping = 0;
+    sys_info->num_zombie = 0;
     
-    printf("Press 'q' to quit top\n");
-    sleep(1);
+    // 첫 회차는 비교할 이전 값이 없으므로 0%로 표시
+    unsigned long cpu_time_diff = s->generation > 1 ? sys_info->total_cpu_time - s->prev_cpu_total : 0;
     
-    while (1) {
-        clear_screen();
-        
-        // 시스템 정보 수집
-        get_system_info(&sys_info);
-        count_processes(&sys_info);
-        
-        // 헤더 정보 출력
-        time_t now = time(NULL);
-        struct tm *tm_info = localtime(&now);
-        printf("top - %02d:%02d:%02d up time, load average: %.2f, %.2f, %.2f\n",
-               tm_info->tm_hour, tm_info->tm_min, tm_info->tm_sec,
-               sys_info.load_avg[0], sys_info.load_avg[1], sys_info.load_avg[2]);
-        
-        printf("Tasks: %d total, %d running, %d sleeping, %d zombie\n",
-               sys_info.num_processes, sys_info.num_running, 
-               sys_info.num_sleeping, sys_info.num_zombie);
+    proc_dir = opendir("/proc");
+    if (!proc_dir) return;
+    
+    while ((entry = readdir(proc_dir)) != NULL) {
+        if (!is_number(entry->d_name)) continue;
         
-        float cpu_usage = 100.0 - ((float)sys_info.idle_cpu_time / sys_info.total_cpu_time * 100.0);
-        printf("%%Cpu(s): %.1f us, %.1f sy, %.1f id\n", cpu_usage * 0.7, cpu_usage * 0.3, 100.0 - cpu_usage);
+        if (s->proc_count == s->proc_capacity) {
+            size_t capacity = s->proc_capacity ? s->proc_capacity * 2 : 512;
+            ProcessInfo *procs = realloc(s->procs, capacity * sizeof(ProcessInfo));
+            if (!procs) break;
+            s->procs = procs;
+            s->proc_capacity = capacity;
+        }
         
-        printf("KiB Mem: %8ld total, %8ld free, %8ld used, %8ld buff/cache\n",
-               sys_info.total_mem, sys_info.free_mem, sys_info.used_mem, sys_info.cached_mem);
+        ProcessInfo *proc = &s->procs[s->proc_count];
+        int created;
+        SampleEntry *sample = sampler_lookup(s, atoi(entry->d_name), &created);
+        if (read_proc_stat(atoi(entry->d_name), sample ? &sample->stat_fd : NULL, proc) != 0) continue;
         
-        printf("\n");
-        printf("  PID USER      PR  NI    VIRT    RES    SHR S  %%CPU %%MEM     TIME+ COMMAND\n");
+        sys_info->num_processes++;
+        switch (proc->state) {
+            case 'R': sys_info->num_running++; break;
+            case 'S': case 'D': sys_info->num_sleeping++; break;
+            case 'Z': sys_info->num_zombie++; break;
+        }
         
-        // 프로세스 정보 수집
-        DIR *proc_dir = opendir("/proc");
-        if (proc_dir) {
-            struct dirent *entry;
-            process_count = 0;
-            
-            while ((entry = readdir(proc_dir)) != NULL && process_count < 100) {
-                if (!is_number(entry->d_name)) continue;
-                
-                int pid = atoi(entry->d_name);
-                ProcessInfo *proc = &processes[process_count];
-                
-                if (get_process_info(pid, proc) == 0) {
-                    proc->cpu_percent = calculate_cpu_usage(proc, sys_info.total_cpu_time, sys_info.idle_cpu_time);
-                    process_count++;
-                }
+        proc->cpu_percent = 0.0;
+        if (sample) {
+            // 지난 회차 이후에 시작한 프로세스(pid가 재사용된 경우 포함)는 시작 후 쓴 시간 전체가 이번 구간의 사용량
+            unsigned long prev = (created || sample->starttime != proc->starttime) ? 0 : sample->prev_total_time;
+            if (cpu_time_diff > 0 && proc->total_time >= prev) {
+                proc->cpu_percent = ((float)(proc->total_time - prev) / cpu_time_diff) * 100.0;
             }
-            closedir(proc_dir);
+            sample->starttime = proc->starttime;
+            sample->prev_total_time = proc->total_time;
+            sample->seen = s->generation;
         }
-        
-        // CPU 사용률 기준으로 정렬 (간단한 버블 정렬)
-        for (int i = 0; i < process_count - 1; i++) {
-            for (int j = 0; j < process_count - i - 1; j++) {
-                if (processes[j].cpu_percent < processes[j + 1].cpu_percent) {
-                    ProcessInfo temp = processes[j];
-                    processes[j] = processes[j + 1];
-                    processes[j + 1] = temp;
-                }
+        s->proc_count++;
+    }
+    closedir(proc_dir);
+    
+    sampler_collect(s);
+    s->prev_cpu_total = sys_info->total_cpu_time;
+}
+
+static int compare_cpu_desc(const void *a, const void *b) {
+    const ProcessInfo *pa = *(ProcessInfo * const *)a;
+    const ProcessInfo *pb = *(ProcessInfo * const *)b;
+    
+    if (pa->cpu_percent != pb->cpu_percent) {
+        return pa->cpu_percent < pb->cpu_percent ? 1 : -1;
+    }
+    return pa->pid - pb->pid;
+}
+
+// CPU 사용률 상위 top_n개를 order 앞쪽에 정렬해 둠 (전체 정렬 대신 선택 후 그 부분만 정렬)
+size_t select_top_processes(Sampler *s, size_t top_n) {
+    size_t n = s->proc_count;
+    
+    if (n > s->order_capacity) {
+        ProcessInfo **order = realloc(s->order, n * sizeof(ProcessInfo *));
+        if (!order) return 0;
+        s->order = order;
+        s->order_capacity = n;
+    }
+    for (size_t i = 0; i < n; i++) {
+        s->order[i] = &s->procs[i];
+    }
+    if (top_n > n) top_n = n;
+    
+    // quickselect: [lo, hi] 안에서 top_n번째 경계가 자리 잡을 때까지 분할
+    size_t lo = 0, hi = n ? n - 1 : 0;
+    while (top_n > 0 && top_n < n && lo < hi) {
+        ProcessInfo *pivot = s->order[lo + (hi - lo) / 2];
+        size_t i = lo, j = hi;
+        while (i <= j) {
+            while (compare_cpu_desc(&s->order[i], &pivot) < 0) i++;
+            while (compare_cpu_desc(&s->order[j], &pivot) > 0) j--;
+            if (i <= j) {
+                ProcessInfo *tmp = s->order[i];
+                s->order[i] = s->order[j];
+                s->order[j] = tmp;
+                i++;
+                if (j == 0) break;
+                j--;
             }
         }
-        
-        // 프로세스 목록 출력 (상위 20개)
-        int display_count = (process_count > 20) ? 20 : process_count;
-        for (int i = 0; i < display_count; i++) {
-            ProcessInfo *proc = &processes[i];
-            printf("%5d %-8s 20   0 %7ld %6ld      0 %c %5.1f %4.1f %8s %s\n",
-                   proc->pid, proc->user, proc->vsz, proc->rss,
-                   proc->state, proc->cpu_percent, proc->mem_percent,
-                   "00:00:00", proc->cmd);
+        if (top_n - 1 <= j) {
+            hi = j;
+        } else if (top_n - 1 >= i) {
+            lo = i;
+        } else {
+            break;
+        }
+    }
+    
+    if (top_n > 1) {
+        qsort(s->order, top_n, sizeof(ProcessInfo *), compare_cpu_desc);
+    }
+    return top_n;
+}
+
+void free_sampler(Sampler *s) {
+    for (size_t i = 0; i < s->capacity; i++) {
+        if (s->slots[i].pid != 0) procfs_close(&s->slots[i].stat_fd);
+    }
+    free(s->slots);
+    free(s->procs);
+    free(s->order);
+    memset(s, 0, sizeof(*s));
+}
+
+// "%Cpu(s):" 형식의 상태별 사용률 한 줄
+static void print_cpu_line(const char *label, const CpuUsage *u) {
+    printf("%-7s: %5.1f us, %5.1f sy, %5.1f ni, %5.1f id, %5.1f wa, %5.1f hi, %5.1f si, %5.1f st\n",
+           label, u->us, u->sy, u->ni, u->id, u->wa, u->hi, u->si, u->st);
+}
+
+// 코어마다 한 글자로 사용률(100 - id - wa)을 10% 단위로 표시 (한 줄에 CPU_HEATMAP_WIDTH개, 8개마다 띄움)
+// 출력한 줄 수를 반환
+static int print_cpu_heatmap(const CpuStats *c) {
+    static const char levels[] = " .:-=+*#%@";
+    int lines = 1;
+    
+    printf("CPU heatmap: %d online, busy 0%% [%s] 100%%, 'x' offline\n", c->num_online, levels);
+    for (int row = 0; row < c->num_cores; row += CPU_HEATMAP_WIDTH) {
+        printf("%5d ", row);
+        for (int id = row; id < row + CPU_HEATMAP_WIDTH && id < c->num_cores; id++) {
+            if (id > row && (id - row) % 8 == 0) putchar(' ');
+            if (!c->online[id]) {
+                putchar('x');
+                continue;
+            }
+            CpuUsage u;
+            cpu_usage(&c->prev_cores[id], &c->cores[id], &u);
+            int level = (int)((100.0 - u.id - u.wa) / 10);
+            if (level < 0) level = 0;
+            if (level > 9) level = 9;
+            putchar(levels[level]);
         }
+        putchar('\n');
+        lines++;
+    }
+    return lines;
+}
+
+// CPU 요약: 기본은 전체 한 줄, per_core면 코어별 줄 (코어가 많으면 전체 한 줄 + 히트맵)
+// 출력한 줄 수를 반환
+static int print_cpu_summary(const CpuStats *c, int per_core) {
+    CpuUsage u;
+    
+    if (per_core && c->num_online > 0 && c->num_online < CPU_HEATMAP_MIN) {
+        for (int id = 0; id < c->num_cores; id++) {
+            if (!c->online[id]) continue;
+            char label[16];
+            snprintf(label, sizeof(label), "%%Cpu%d", id);
+            cpu_usage(&c->prev_cores[id], &c->cores[id], &u);
+            print_cpu_line(label, &u);
+        }
+        return c->num_online;
+    }
+    
+    cpu_usage(&c->prev_total, &c->total, &u);
+    print_cpu_line("%Cpu(s)", &u);
+    if (per_core && c->num_online > 0) {
+        return 1 + print_cpu_heatmap(c);
+    }
+    return 1;
+}
+
+// top 출력 형식
+enum {
+    TOP_FORMAT_TEXT,
+    TOP_FORMAT_JSON,
+    TOP_FORMAT_CSV
+};
+
+// top 실행 옵션
+typedef struct {
+    int batch;                      // -b: 터미널 제어 없이 표본마다 이어서 출력
+    long iterations;                // -n: 표본 수 (0이면 q를 누를 때까지)
+    double delay;                   // -d: 갱신 간격 (초)
+    long rows;                      // -r: 표시할 프로세스 수 (-1이면 대화형은 화면 크기, 배치는 전부)
+    int format;                     // -o: text, json, csv (배치 모드에서만)
+} TopOptions;
+
+static void print_top_usage(void) {
+    printf("Usage: top [-b] [-n count] [-d seconds] [-r rows] [-o text|json|csv]\n");
+    printf("  -b          batch mode (no terminal control, print every sample)\n");
+    printf("  -n count    number of samples, 0 for unlimited (default 0)\n");
+    printf("  -d seconds  delay between samples (default %.1f)\n", TOP_DEFAULT_DELAY);
+    printf("  -r rows     number of processes per sample, 0 for all\n");
+    printf("  -o format   batch output format: text, json or csv (default text)\n");
+}
+
+// top 옵션 파싱 (잘못된 옵션이면 사용법을 출력하고 -1 반환)
+static int parse_top_options(int argc, char **args, TopOptions *opt) {
+    opt->batch = 0;
+    opt->iterations = 0;
+    opt->delay = TOP_DEFAULT_DELAY;
+    opt->rows = -1;
+    opt->format = TOP_FORMAT_TEXT;
+    
+    for (int i = 1; i < argc; i++) {
+        const char *arg = args[i];
+        char *end;
         
-        printf("\nPress 'q' to quit, any other key to refresh...");
-        fflush(stdout);
+        if (strcmp(arg, "-b") == 0) {
+            opt->batch = 1;
+            continue;
+        }
+        if (strcmp(arg, "-n") != 0 && strcmp(arg, "-d") != 0 &&
+            strcmp(arg, "-r") != 0 && strcmp(arg, "-o") != 0) {
+            printf("top: unknown option '%s'\n", arg);
+            print_top_usage();
+            return -1;
+        }
+        if (i + 1 >= argc) {
+            printf("top: option '%s' requires an argument\n", arg);
+            print_top_usage();
+            return -1;
+        }
         
-        // 키 입력 확인 (non-blocking)
-        char ch;
-        if (read(STDIN_FILENO, &ch, 1) > 0) {
-            if (ch == 'q' || ch == 'Q') {
-                break;
+        const char *value = args[++i];
+        errno = 0;
+        if (strcmp(arg, "-n") == 0 || strcmp(arg, "-r") == 0) {
+            long n = strtol(value, &end, 10);
+            if (errno || end == value || *end != '\0' || n < 0) {
+                printf("top: invalid number '%s' for %s\n", value, arg);
+                return -1;
+            }
+            if (arg[1] == 'n') {
+                opt->iterations = n;
+            } else {
+                opt->rows = n;
+            }
+        } else if (strcmp(arg, "-d") == 0) {
+            double delay = strtod(value, &end);
+            if (errno || end == value || *end != '\0' || !(delay >= 0.01)) {
+                printf("top: invalid delay '%s' (minimum 0.01 seconds)\n", value);
+                return -1;
             }
+            opt->delay = delay;
+        } else if (strcmp(value, "text") == 0) {
+            opt->format = TOP_FORMAT_TEXT;
+        } else if (strcmp(value, "json") == 0) {
+            opt->format = TOP_FORMAT_JSON;
+        } else if (strcmp(value, "csv") == 0) {
+            opt->format = TOP_FORMAT_CSV;
+        } else {
+            printf("top: unknown format '%s' (text, json or csv)\n", value);
+            return -1;
         }
-        
-        sleep(2);  // 2초마다 갱신
     }
     
-    set_terminal_mode(0);  // 터미널 모드 복원
-    clear_screen();
-    printf("Exited top mode.\n");
+    if (opt->format != TOP_FORMAT_TEXT && !opt->batch) {
+        printf("top: -o %s requires batch mode (-b)\n", opt->format == TOP_FORMAT_JSON ? "json" : "csv");
+        return -1;
+    }
+    return 0;
 }
-float calculate_mem_percent(long rss) {
-    FILE *file = fopen("/proc/meminfo", "r");
-    if (!file) return 0.0;
+
+// 초를 timerfd 간격으로
+static struct timespec seconds_to_timespec(double seconds) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)seconds;
+    ts.tv_nsec = (long)((seconds - ts.tv_sec) * 1e9);
+    return ts;
+}
+
+// 터미널 줄 수 (알 수 없으면 TOP_DEFAULT_ROWS)
+static int terminal_rows(void) {
+    struct winsize ws;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_row > 0) {
+        return ws.ws_row;
+    }
+    return TOP_DEFAULT_ROWS;
+}
+
+// 화면에 나올 프로세스의 사용자 이름과 메모리 사용률을 채움
+static void fill_display_info(ProcessInfo *proc) {
+    if (read_proc_status(proc->pid, proc) != 0) {
+        strcpy(proc->user, "?");
+    }
+    proc->mem_percent = calculate_mem_percent(proc->rss);
+}
+
+// JSON 문자열 출력 (따옴표, 역슬래시, 제어 문자 이스케이프)
+static void print_json_string(const char *str) {
+    putchar('"');
+    for (const unsigned char *p = (const unsigned char *)str; *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            printf("\\%c", *p);
+        } else if (*p < 0x20) {
+            printf("\\u%04x", *p);
+        } else {
+            putchar(*p);
+        }
+    }
+    putchar('"');
+}
+
+// CSV 필드 출력 (항상 따옴표로 감싸고 안의 따옴표는 두 번 씀)
+static void print_csv_string(const char *str) {
+    putchar('"');
+    for (const char *p = str; *p; p++) {
+        if (*p == '"') putchar('"');
+        putchar(*p);
+    }
+    putchar('"');
+}
+
+static void print_json_usage(const CpuUsage *u) {
+    printf("{\"us\":%.1f,\"sy\":%.1f,\"ni\":%.1f,\"id\":%.1f,\"wa\":%.1f,\"hi\":%.1f,\"si\":%.1f,\"st\":%.1f}",
+           u->us, u->sy, u->ni, u->id, u->wa, u->hi, u->si, u->st);
+}
+
+// 표본 하나를 JSON 한 줄로 출력 (줄마다 독립된 객체라 그대로 수집기에 넘길 수 있음)
+static void print_json_sample(double timestamp, const SystemInfo *sys_info, const CpuStats *c,
+                              ProcessInfo **procs, size_t count) {
+    CpuUsage u;
     
-    char line[256];
-    long total_mem = 0;
+    printf("{\"time\":%.3f,\"load\":[%.2f,%.2f,%.2f],", timestamp,
+           sys_info->load_avg[0], sys_info->load_avg[1], sys_info->load_avg[2]);
+    printf("\"tasks\":{\"total\":%d,\"running\":%d,\"sleeping\":%d,\"zombie\":%d},",
+           sys_info->num_processes, sys_info->num_running, sys_info->num_sleeping, sys_info->num_zombie);
     
-    while (fgets(line, sizeof(line), file)) {
-        if (strncmp(line, "MemTotal:", 9) == 0) {
-            sscanf(line, "MemTotal: %ld kB", &total_mem);
+    cpu_usage(&c->prev_total, &c->total, &u);
+    printf("\"cpu\":");
+    print_json_usage(&u);
+    printf(",\"cpus\":[");
+    int first = 1;
+    for (int id = 0; id < c->num_cores; id++) {
+        if (!c->online[id]) continue;
+        cpu_usage(&c->prev_cores[id], &c->cores[id], &u);
+        printf("%s{\"id\":%d,\"usage\":", first ? "" : ",", id);
+        print_json_usage(&u);
+        putchar('}');
+        first = 0;
+    }
+    
+    printf("],\"mem\":{\"total\":%ld,\"free\":%ld,\"used\":%ld,\"cached\":%ld},\"procs\":[",
+           sys_info->total_mem, sys_info->free_mem, sys_info->used_mem, sys_info->cached_mem);
+    for (size_t i = 0; i < count; i++) {
+        ProcessInfo *proc = procs[i];
+        printf("%s{\"pid\":%d,\"user\":", i ? "," : "", proc->pid);
+        print_json_string(proc->user);
+        printf(",\"state\":\"%c\",\"cpu\":%.1f,\"mem\":%.1f,\"virt\":%ld,\"res\":%ld,\"command\":",
+               proc->state, proc->cpu_percent, proc->mem_percent, proc->vsz, proc->rss);
+        print_json_string(proc->cmd);
+        putchar('}');
+    }
+    printf("]}\n");
+}
+
+// 표본 하나를 CSV로 출력 (프로세스마다 한 줄, 머리글은 첫 표본 앞에 한 번)
+static void print_csv_sample(double timestamp, int header, ProcessInfo **procs, size_t count) {
+    if (header) {
+        printf("time,pid,user,state,cpu,mem,virt,res,command\n");
+    }
+    for (size_t i = 0; i < count; i++) {
+        ProcessInfo *proc = procs[i];
+        printf("%.3f,%d,", timestamp, proc->pid);
+        print_csv_string(proc->user);
+        printf(",%c,%.1f,%.1f,%ld,%ld,", proc->state, proc->cpu_percent, proc->mem_percent, proc->vsz, proc->rss);
+        print_csv_string(proc->cmd);
+        putchar('\n');
+    }
+}
+
+// 표본 하나를 화면 형식으로 출력 (max_rows가 0이면 전부, 음수면 screen_rows에서 남는 줄 수만큼)
+static void print_text_sample(const SystemInfo *sys_info, const CpuStats *c, Sampler *s,
+                              int per_core, long max_rows, int screen_rows) {
+    time_t now = time(NULL);
+    struct tm *tm_info = localtime(&now);
+    printf("top - %02d:%02d:%02d up time, load average: %.2f, %.2f, %.2f\n",
+           tm_info->tm_hour, tm_info->tm_min, tm_info->tm_sec,
+           sys_info->load_avg[0], sys_info->load_avg[1], sys_info->load_avg[2]);
+    
+    printf("Tasks: %d total, %d running, %d sleeping, %d zombie\n",
+           sys_info->num_processes, sys_info->num_running, 
+           sys_info->num_sleeping, sys_info->num_zombie);
+    
+    int cpu_lines = print_cpu_summary(c, per_core);
+    
+    printf("KiB Mem: %8ld total, %8ld free, %8ld used, %8ld buff/cache\n",
+           sys_info->total_mem, sys_info->free_mem, sys_info->used_mem, sys_info->cached_mem);
+    
+    printf("\n");
+    printf("  PID USER      PR  NI    VIRT    RES    SHR S  %%CPU %%MEM     TIME+ COMMAND\n");
+    
+    // 화면에 맞출 때는 머리글 (CPU 줄 외 5줄)과 아래 안내 (2줄)를 뺀 나머지에 프로세스 표시
+    size_t limit;
+    if (max_rows < 0) {
+        long fit = screen_rows - (cpu_lines + 5) - 2;
+        limit = fit > 0 ? (size_t)fit : 0;
+    } else {
+        limit = max_rows == 0 ? s->proc_count : (size_t)max_rows;
+    }
+    size_t display_count = select_top_processes(s, limit);
+    for (size_t i = 0; i < display_count; i++) {
+        ProcessInfo *proc = s->order[i];
+        fill_display_info(proc);
+        printf("%5d %-8s 20   0 %7ld %6ld      0 %c %5.1f %4.1f %8s %s\n",
+               proc->pid, proc->user, proc->vsz, proc->rss,
+               proc->state, proc->cpu_percent, proc->mem_percent,
+               "00:00:00", proc->cmd);
+    }
+}
+
+// top 명령어 구현
+// timerfd로 갱신 시각을 맞추고, 대화형이면 poll로 타이머와 키 입력을 함께 기다림
+void top_command(int argc, char **args) {
+    TopOptions opt;
+    SystemInfo sys_info;
+    Sampler sampler = {0};
+    CpuStats cpu_stats = {0};
+    int per_core = 0;               // '1' 키로 코어별 보기 전환
+    
+    if (parse_top_options(argc, args, &opt) != 0) return;
+    
+    int timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (timer_fd < 0) {
+        perror("top: timerfd_create");
+        return;
+    }
+    
+    // 기준 표본을 먼저 읽어 두고, 첫 출력은 최대 1초 뒤 (그 뒤로는 delay마다)
+    get_system_info(&sys_info, &cpu_stats);
+    sample_processes(&sampler, &sys_info);
+    
+    struct itimerspec its;
+    its.it_value = seconds_to_timespec(opt.delay < 1.0 ? opt.delay : 1.0);
+    its.it_interval = seconds_to_timespec(opt.delay);
+    if (timerfd_settime(timer_fd, 0, &its, NULL) != 0) {
+        perror("top: timerfd_settime");
+        close(timer_fd);
+        free_sampler(&sampler);
+        free_cpu_stats(&cpu_stats);
+        return;
+    }
+    
+    if (!opt.batch) {
+        set_terminal_mode(1);
+        printf("Press 'q' to quit top\n");
+        fflush(stdout);
+    }
+    
+    struct pollfd fds[2];
+    fds[0].fd = timer_fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = STDIN_FILENO;
+    fds[1].events = POLLIN;
+    int nfds = opt.batch ? 1 : 2;
+    
+    long samples = 0;
+    int quit = 0;
+    while (!quit && (opt.iterations == 0 || samples < opt.iterations)) {
+        int refresh = 0;
+        
+        if (poll(fds, nfds, -1) < 0) {
+            if (errno == EINTR) continue;
+            perror("top: poll");
             break;
         }
+        
+        if (fds[0].revents & POLLIN) {
+            uint64_t expirations;
+            if (read(timer_fd, &expirations, sizeof(expirations)) == sizeof(expirations)) {
+                refresh = 1;
+            }
+        }
+        
+        if (nfds > 1 && fds[1].revents) {
+            char ch;
+            ssize_t n = read(STDIN_FILENO, &ch, 1);
+            if (n <= 0) {
+                // 입력이 닫혔으면 더 받을 키가 없으므로 끝냄
+                quit = 1;
+            } else if (ch == 'q' || ch == 'Q') {
+                quit = 1;
+            } else if (samples > 0) {
+                // 다른 키는 바로 다시 그림 (타이머 주기는 그대로)
+                if (ch == '1') per_core = !per_core;
+                refresh = 1;
+            }
+        }
+        
+        if (quit || !refresh) continue;
+        
+        // 키로 다시 그릴 때는 새 표본 없이 마지막 표본을 다시 보여 줌 (구간 사용률이 흔들리지 않게)
+        if (fds[0].revents & POLLIN) {
+            get_system_info(&sys_info, &cpu_stats);
+            sample_processes(&sampler, &sys_info);
+        }
+        
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        double timestamp = ts.tv_sec + ts.tv_nsec / 1e9;
+        
+        if (!opt.batch) {
+            clear_screen();
+            print_text_sample(&sys_info, &cpu_stats, &sampler, per_core, opt.rows, terminal_rows());
+            printf("\nPress 'q' to quit, '1' to toggle per-CPU view...");
+        } else if (opt.format == TOP_FORMAT_TEXT) {
+            if (samples > 0) printf("\n");
+            print_text_sample(&sys_info, &cpu_stats, &sampler, 0, opt.rows == -1 ? 0 : opt.rows, 0);
+        } else {
+            size_t count = select_top_processes(&sampler, opt.rows > 0 ? (size_t)opt.rows : sampler.proc_count);
+            for (size_t i = 0; i < count; i++) {
+                fill_display_info(sampler.order[i]);
+            }
+            if (opt.format == TOP_FORMAT_JSON) {
+                print_json_sample(timestamp, &sys_info, &cpu_stats, sampler.order, count);
+            } else {
+                print_csv_sample(timestamp, samples == 0, sampler.order, count);
+            }
+        }
+        fflush(stdout);
+        samples++;
     }
-    fclose(file);
     
-    if (total_mem > 0) {
-        return ((float)rss / total_mem) * 100.0;
+    close(timer_fd);
+    free_sampler(&sampler);
+    free_cpu_stats(&cpu_stats);
+    if (!opt.batch) {
+        set_terminal_mode(0);  // 터미널 모드 복원
+        clear_screen();
+        printf("Exited top mode.\n");
     }
-    return 0.0;
 }
 
 // kill 명령어 구현
@@ -505,6 +1092,8 @@ void find_processes_by_name(const char *name) {
         return;
     }
     
+    refresh_mem_total();
+    
     printf("Found processes matching '%s':\n", name);
     printf("  PID USER     COMMAND\n");
     
@@ -527,7 +1116,7 @@ void find_processes_by_name(const char *name) {
     closedir(proc_dir);
 }
 int get_process_info(int pid, ProcessInfo *proc) {
-    if (read_proc_stat(pid, proc) != 0) return -1;
+    if (read_proc_stat(pid, NULL, proc) != 0) return -1;
     if (read_proc_status(pid, proc) != 0) return -1;
     
     proc->cpu_percent = 0.0; // 간단한 구현에서는 0으로 설정
@@ -557,6 +1146,8 @@ void ps_command(int show_all) {
         printf("  PID TTY          TIME CMD\n");
     }
     
+    refresh_mem_total();
+    
     while ((entry = readdir(proc_dir)) != NULL) {
         if (!is_number(entry->d_name)) continue;
         
@@ -579,12 +1170,12 @@ void ps_command(int show_all) {
 // 명령어 파싱 및 실행
 void execute_command(char *cmd) {
     char *token;
-    char *args[10];
+    char *args[16];
     int argc = 0;
     
     // 명령어를 공백으로 분리
     token = strtok(cmd, " \t\n");
-    while (token != NULL && argc < 9) {
+    while (token != NULL && argc < 15) {
         args[argc++] = token;
         token = strtok(NULL, " \t\n");
     }
@@ -606,6 +1197,22 @@ void execute_command(char *cmd) {
         
         ps_command(show_all);
     }
+    // kill 명령어 처리
+    else if (strcmp(args[0], "kill") == 0) {
+        kill_command(argc, args);
+    }
+    // top 명령어 처리
+    else if (strcmp(args[0], "top") == 0) {
+        top_command(argc, args);
+    }
+    // pgrep 명령어 (프로세스 이름으로 검색)
+    else if (strcmp(args[0], "pgrep") == 0) {
+        if (argc < 2) {
+            printf("Usage: pgrep <process_name>\n");
+        } else {
+            find_processes_by_name(args[1]);
+        }
+    }
     // exit 명령어
     else if (strcmp(args[0], "exit") == 0) {
         printf("Goodbye!\n");
@@ -622,6 +1229,8 @@ void execute_command(char *cmd) {
         printf("  kill -9 <PID>   - Send SIGKILL to process (force kill)\n");
         printf("  kill -15 <PID>  - Send SIGTERM to process\n");
         printf("  pgrep <name>    - Find processes by name\n");
+        printf("  top             - Display processes sorted by CPU usage\n");
+        printf("  top -b -n 5 -d 1 -o json - Print 5 samples 1s apart as JSON lines\n");
         printf("  help            - Show this help message\n");
         printf("  exit            - Exit the terminal\n");
     }